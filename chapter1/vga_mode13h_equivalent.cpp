@@ -3,6 +3,12 @@
 #include <unistd.h>
 #include <iostream>
 #include <cmath>
+#include <vector>
+#include <algorithm>
+#include <cstring>
+
+//SIMD intrinsics
+#include <immintrin.h>  // AVX2 palette resolve (scalar fallback otherwise)
 
 //SDL3 library
 
@@ -47,25 +53,66 @@ struct VGAPalette {
             }
         }
     }
+    
+    // Classic VGA palette cycling: rotate entries [first, first + count)
+    void rotate(int first, int count, int step = 1) {
+        step = ((step % count) + count) % count;
+        std::rotate(colors + first, colors + first + step, colors + first + count);
+    }
 };
 
 static VGAPalette vga_palette;
 
+// Mode 13h style indexed surface: one byte per pixel, rows padded to 32 bytes
+struct IndexedSurface {
+    int w;
+    int h;
+    int pitch; // bytes per row
+    vector<uint8_t> pixels;
+    
+    IndexedSurface(int width, int height) : w(width), h(height) {
+        pitch = (w + 31) & ~31;
+        pixels.assign((size_t)pitch * h, 0);
+    }
+};
+
 // Modern equivalent of VGA Mode 13h put_pixel function
-void put_pixel(SDL_Surface* surface, int x, int y, uint8_t color_index) {
-    if (x < 0 || x >= surface->w || y < 0 || y >= surface->h) return;
+void put_pixel(IndexedSurface& surface, int x, int y, uint8_t color_index) {
+    if (x < 0 || x >= surface.w || y < 0 || y >= surface.h) return;
     
-    uint32_t* pixels = (uint32_t*)surface->pixels;
-    int pitch = surface->pitch / 4;
-    pixels[y * pitch + x] = vga_palette.colors[color_index];
+    surface.pixels[y * surface.pitch + x] = color_index;
 }
 
-// Classic VGA demo: plasma effect
-void draw_plasma_effect(SDL_Surface* surface, double time) {
-    SDL_LockSurface(surface);
+// Expand the indexed surface to ARGB8888 through the palette (done once per present)
+void resolve_indexed(const IndexedSurface& src, const VGAPalette& palette, SDL_Surface* dst) {
+    SDL_LockSurface(dst);
+    int width = min(src.w, dst->w);
+    int height = min(src.h, dst->h);
+    
+    for (int y = 0; y < height; ++y) {
+        const uint8_t* in = src.pixels.data() + (size_t)y * src.pitch;
+        uint32_t* out = (uint32_t*)((uint8_t*)dst->pixels + (size_t)y * dst->pitch);
+        int x = 0;
+#ifdef __AVX2__
+        // Zero-extend 8 indices and gather 8 palette entries at once
+        for (; x + 8 <= width; x += 8) {
+            __m256i idx = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(in + x)));
+            _mm256_storeu_si256((__m256i*)(out + x),
+                _mm256_i32gather_epi32((const int*)palette.colors, idx, 4));
+        }
+#endif
+        for (; x < width; ++x) {
+            out[x] = palette.colors[in[x]];
+        }
+    }
     
-    for (int y = 0; y < surface->h; ++y) {
-        for (int x = 0; x < surface->w; ++x) {
+    SDL_UnlockSurface(dst);
+}
+
+// Classic VGA demo: plasma effect
+void draw_plasma_effect(IndexedSurface& surface, double time) {
+    for (int y = 0; y < surface.h; ++y) {
+        for (int x = 0; x < surface.w; ++x) {
             // Plasma formula typical of VGA demos
             double value = sin(x * 0.04 + time) + 
                           sin(y * 0.03 + time * 1.5) + 
@@ -76,43 +123,197 @@ void draw_plasma_effect(SDL_Surface* surface, double time) {
             put_pixel(surface, x, y, color);
         }
     }
-    
-    SDL_UnlockSurface(surface);
 }
 
-// Draw classic VGA-style text (8x8 bitmap font simulation)
-void draw_text(SDL_Surface* surface, const char* text, int start_x, int start_y, uint8_t color) {
-    SDL_LockSurface(surface);
-    
-    int x = start_x;
-    int y = start_y;
-    
-    for (const char* c = text; *c; ++c) {
-        if (*c == '\n') {
-            x = start_x;
-            y += 9;
-            continue;
+// Classic 8x8 bitmap font for printable ASCII (0x20-0x7E)
+// One byte per glyph row, bit 0 = leftmost pixel
+static const uint8_t FONT_8X8[95][8] = {
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // space
+    {0x18, 0x3C, 0x3C, 0x18, 0x18, 0x00, 0x18, 0x00}, // !
+    {0x36, 0x36, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // "
+    {0x36, 0x36, 0x7F, 0x36, 0x7F, 0x36, 0x36, 0x00}, // #
+    {0x0C, 0x3E, 0x03, 0x1E, 0x30, 0x1F, 0x0C, 0x00}, // $
+    {0x00, 0x63, 0x33, 0x18, 0x0C, 0x66, 0x63, 0x00}, // %
+    {0x1C, 0x36, 0x1C, 0x6E, 0x3B, 0x33, 0x6E, 0x00}, // &
+    {0x06, 0x06, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00}, // '
+    {0x18, 0x0C, 0x06, 0x06, 0x06, 0x0C, 0x18, 0x00}, // (
+    {0x06, 0x0C, 0x18, 0x18, 0x18, 0x0C, 0x06, 0x00}, // )
+    {0x00, 0x66, 0x3C, 0xFF, 0x3C, 0x66, 0x00, 0x00}, // *
+    {0x00, 0x0C, 0x0C, 0x3F, 0x0C, 0x0C, 0x00, 0x00}, // +
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x0C, 0x0C, 0x06}, // ,
+    {0x00, 0x00, 0x00, 0x3F, 0x00, 0x00, 0x00, 0x00}, // -
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x0C, 0x0C, 0x00}, // .
+    {0x60, 0x30, 0x18, 0x0C, 0x06, 0x03, 0x01, 0x00}, // /
+    {0x3E, 0x63, 0x73, 0x7B, 0x6F, 0x67, 0x3E, 0x00}, // 0
+    {0x0C, 0x0E, 0x0C, 0x0C, 0x0C, 0x0C, 0x3F, 0x00}, // 1
+    {0x1E, 0x33, 0x30, 0x1C, 0x06, 0x33, 0x3F, 0x00}, // 2
+    {0x1E, 0x33, 0x30, 0x1C, 0x30, 0x33, 0x1E, 0x00}, // 3
+    {0x38, 0x3C, 0x36, 0x33, 0x7F, 0x30, 0x78, 0x00}, // 4
+    {0x3F, 0x03, 0x1F, 0x30, 0x30, 0x33, 0x1E, 0x00}, // 5
+    {0x1C, 0x06, 0x03, 0x1F, 0x33, 0x33, 0x1E, 0x00}, // 6
+    {0x3F, 0x33, 0x30, 0x18, 0x0C, 0x0C, 0x0C, 0x00}, // 7
+    {0x1E, 0x33, 0x33, 0x1E, 0x33, 0x33, 0x1E, 0x00}, // 8
+    {0x1E, 0x33, 0x33, 0x3E, 0x30, 0x18, 0x0E, 0x00}, // 9
+    {0x00, 0x0C, 0x0C, 0x00, 0x00, 0x0C, 0x0C, 0x00}, // :
+    {0x00, 0x0C, 0x0C, 0x00, 0x00, 0x0C, 0x0C, 0x06}, // ;
+    {0x18, 0x0C, 0x06, 0x03, 0x06, 0x0C, 0x18, 0x00}, // <
+    {0x00, 0x00, 0x3F, 0x00, 0x00, 0x3F, 0x00, 0x00}, // =
+    {0x06, 0x0C, 0x18, 0x30, 0x18, 0x0C, 0x06, 0x00}, // >
+    {0x1E, 0x33, 0x30, 0x18, 0x0C, 0x00, 0x0C, 0x00}, // ?
+    {0x3E, 0x63, 0x7B, 0x7B, 0x7B, 0x03, 0x1E, 0x00}, // @
+    {0x0C, 0x1E, 0x33, 0x33, 0x3F, 0x33, 0x33, 0x00}, // A
+    {0x3F, 0x66, 0x66, 0x3E, 0x66, 0x66, 0x3F, 0x00}, // B
+    {0x3C, 0x66, 0x03, 0x03, 0x03, 0x66, 0x3C, 0x00}, // C
+    {0x1F, 0x36, 0x66, 0x66, 0x66, 0x36, 0x1F, 0x00}, // D
+    {0x7F, 0x46, 0x16, 0x1E, 0x16, 0x46, 0x7F, 0x00}, // E
+    {0x7F, 0x46, 0x16, 0x1E, 0x16, 0x06, 0x0F, 0x00}, // F
+    {0x3C, 0x66, 0x03, 0x03, 0x73, 0x66, 0x7C, 0x00}, // G
+    {0x33, 0x33, 0x33, 0x3F, 0x33, 0x33, 0x33, 0x00}, // H
+    {0x1E, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x1E, 0x00}, // I
+    {0x78, 0x30, 0x30, 0x30, 0x33, 0x33, 0x1E, 0x00}, // J
+    {0x67, 0x66, 0x36, 0x1E, 0x36, 0x66, 0x67, 0x00}, // K
+    {0x0F, 0x06, 0x06, 0x06, 0x46, 0x66, 0x7F, 0x00}, // L
+    {0x63, 0x77, 0x7F, 0x7F, 0x6B, 0x63, 0x63, 0x00}, // M
+    {0x63, 0x67, 0x6F, 0x7B, 0x73, 0x63, 0x63, 0x00}, // N
+    {0x1C, 0x36, 0x63, 0x63, 0x63, 0x36, 0x1C, 0x00}, // O
+    {0x3F, 0x66, 0x66, 0x3E, 0x06, 0x06, 0x0F, 0x00}, // P
+    {0x1E, 0x33, 0x33, 0x33, 0x3B, 0x1E, 0x38, 0x00}, // Q
+    {0x3F, 0x66, 0x66, 0x3E, 0x36, 0x66, 0x67, 0x00}, // R
+    {0x1E, 0x33, 0x07, 0x0E, 0x38, 0x33, 0x1E, 0x00}, // S
+    {0x3F, 0x2D, 0x0C, 0x0C, 0x0C, 0x0C, 0x1E, 0x00}, // T
+    {0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x3F, 0x00}, // U
+    {0x33, 0x33, 0x33, 0x33, 0x33, 0x1E, 0x0C, 0x00}, // V
+    {0x63, 0x63, 0x63, 0x6B, 0x7F, 0x77, 0x63, 0x00}, // W
+    {0x63, 0x63, 0x36, 0x1C, 0x1C, 0x36, 0x63, 0x00}, // X
+    {0x33, 0x33, 0x33, 0x1E, 0x0C, 0x0C, 0x1E, 0x00}, // Y
+    {0x7F, 0x63, 0x31, 0x18, 0x4C, 0x66, 0x7F, 0x00}, // Z
+    {0x1E, 0x06, 0x06, 0x06, 0x06, 0x06, 0x1E, 0x00}, // [
+    {0x03, 0x06, 0x0C, 0x18, 0x30, 0x60, 0x40, 0x00}, // backslash
+    {0x1E, 0x18, 0x18, 0x18, 0x18, 0x18, 0x1E, 0x00}, // ]
+    {0x08, 0x1C, 0x36, 0x63, 0x00, 0x00, 0x00, 0x00}, // ^
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF}, // _
+    {0x0C, 0x0C, 0x18, 0x00, 0x00, 0x00, 0x00, 0x00}, // `
+    {0x00, 0x00, 0x1E, 0x30, 0x3E, 0x33, 0x6E, 0x00}, // a
+    {0x07, 0x06, 0x06, 0x3E, 0x66, 0x66, 0x3B, 0x00}, // b
+    {0x00, 0x00, 0x1E, 0x33, 0x03, 0x33, 0x1E, 0x00}, // c
+    {0x38, 0x30, 0x30, 0x3E, 0x33, 0x33, 0x6E, 0x00}, // d
+    {0x00, 0x00, 0x1E, 0x33, 0x3F, 0x03, 0x1E, 0x00}, // e
+    {0x1C, 0x36, 0x06, 0x0F, 0x06, 0x06, 0x0F, 0x00}, // f
+    {0x00, 0x00, 0x6E, 0x33, 0x33, 0x3E, 0x30, 0x1F}, // g
+    {0x07, 0x06, 0x36, 0x6E, 0x66, 0x66, 0x67, 0x00}, // h
+    {0x0C, 0x00, 0x0E, 0x0C, 0x0C, 0x0C, 0x1E, 0x00}, // i
+    {0x30, 0x00, 0x30, 0x30, 0x30, 0x33, 0x33, 0x1E}, // j
+    {0x07, 0x06, 0x66, 0x36, 0x1E, 0x36, 0x67, 0x00}, // k
+    {0x0E, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x1E, 0x00}, // l
+    {0x00, 0x00, 0x33, 0x7F, 0x7F, 0x6B, 0x63, 0x00}, // m
+    {0x00, 0x00, 0x1F, 0x33, 0x33, 0x33, 0x33, 0x00}, // n
+    {0x00, 0x00, 0x1E, 0x33, 0x33, 0x33, 0x1E, 0x00}, // o
+    {0x00, 0x00, 0x3B, 0x66, 0x66, 0x3E, 0x06, 0x0F}, // p
+    {0x00, 0x00, 0x6E, 0x33, 0x33, 0x3E, 0x30, 0x78}, // q
+    {0x00, 0x00, 0x3B, 0x6E, 0x66, 0x06, 0x0F, 0x00}, // r
+    {0x00, 0x00, 0x3E, 0x03, 0x1E, 0x30, 0x1F, 0x00}, // s
+    {0x08, 0x0C, 0x3E, 0x0C, 0x0C, 0x2C, 0x18, 0x00}, // t
+    {0x00, 0x00, 0x33, 0x33, 0x33, 0x33, 0x6E, 0x00}, // u
+    {0x00, 0x00, 0x33, 0x33, 0x33, 0x1E, 0x0C, 0x00}, // v
+    {0x00, 0x00, 0x63, 0x6B, 0x7F, 0x7F, 0x36, 0x00}, // w
+    {0x00, 0x00, 0x63, 0x36, 0x1C, 0x36, 0x63, 0x00}, // x
+    {0x00, 0x00, 0x33, 0x33, 0x33, 0x3E, 0x30, 0x1F}, // y
+    {0x00, 0x00, 0x3F, 0x19, 0x0C, 0x26, 0x3F, 0x00}, // z
+    {0x38, 0x0C, 0x0C, 0x07, 0x0C, 0x0C, 0x38, 0x00}, // {
+    {0x18, 0x18, 0x18, 0x00, 0x18, 0x18, 0x18, 0x00}, // |
+    {0x07, 0x0C, 0x0C, 0x38, 0x0C, 0x0C, 0x07, 0x00}, // }
+    {0x6E, 0x3B, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // ~
+};
+
+// One string to draw into the indexed surface
+struct TextRun {
+    int x;
+    int y;
+    const char* text;
+    uint8_t color;
+};
+
+// Expands an 8-bit glyph row into an 8-byte select mask (0xFF where the bit is set)
+struct RowByteMasks {
+    uint8_t bytes[256][8];
+
+    RowByteMasks() {
+        for (int bits = 0; bits < 256; ++bits) {
+            for (int i = 0; i < 8; ++i) {
+                bytes[bits][i] = (bits >> i) & 1 ? 0xFF : 0x00;
+            }
         }
-        
-        // Simple 8x8 character rendering (just bars for demo)
-        for (int dy = 0; dy < 8; ++dy) {
-            for (int dx = 0; dx < 8; ++dx) {
-                // Simple pattern based on character
-                if ((*c * (dx + 1) + dy) % 3 == 0) {
-                    put_pixel(surface, x + dx, y + dy, color);
+    }
+};
+
+static const RowByteMasks row_byte_masks;
+
+// Batched VGA text: each run is measured and clipped once. Glyphs fully on
+// the surface are written as one masked 8-byte store per row; only glyphs
+// straddling an edge walk their bits with per-glyph clipping.
+void draw_text_runs(IndexedSurface& surface, const TextRun* runs, size_t count) {
+    const int glyph_size = 8;
+    const int line_height = 9;
+
+    for (size_t i = 0; i < count; ++i) {
+        const TextRun& run = runs[i];
+
+        // Layout pass: bounding box of the whole run
+        int columns = 0, max_columns = 0, lines = 1;
+        for (const char* c = run.text; *c; ++c) {
+            if (*c == '\n') { max_columns = max(max_columns, columns); columns = 0; ++lines; }
+            else ++columns;
+        }
+        max_columns = max(max_columns, columns);
+        int x1 = run.x + max_columns * glyph_size;
+        int y1 = run.y + (lines - 1) * line_height + glyph_size;
+        if (x1 <= 0 || y1 <= 0 || run.x >= surface.w || run.y >= surface.h) continue;
+        bool inside = run.x >= 0 && run.y >= 0 && x1 <= surface.w && y1 <= surface.h;
+
+        uint64_t fill = 0x0101010101010101ull * run.color;
+        int pen_x = run.x;
+        int pen_y = run.y;
+        for (const char* c = run.text; *c; ++c) {
+            if (*c == '\n') {
+                pen_x = run.x;
+                pen_y += line_height;
+                continue;
+            }
+
+            unsigned char ch = (unsigned char)*c;
+            const uint8_t* glyph = FONT_8X8[(ch >= 0x20 && ch < 0x7F ? ch : '?') - 0x20];
+            if (inside || (pen_x >= 0 && pen_y >= 0 &&
+                           pen_x + glyph_size <= surface.w && pen_y + glyph_size <= surface.h)) {
+                uint8_t* dst = surface.pixels.data() + (size_t)pen_y * surface.pitch + pen_x;
+                for (int r = 0; r < glyph_size; ++r, dst += surface.pitch) {
+                    if (!glyph[r]) continue;
+                    uint64_t mask, pixels;
+                    memcpy(&mask, row_byte_masks.bytes[glyph[r]], 8);
+                    memcpy(&pixels, dst, 8);
+                    pixels = (pixels & ~mask) | (fill & mask);
+                    memcpy(dst, &pixels, 8);
+                }
+            } else {
+                int row_start = max(0, -pen_y), row_end = min(glyph_size, surface.h - pen_y);
+                int col_start = max(0, -pen_x), col_end = min(glyph_size, surface.w - pen_x);
+                unsigned col_mask = col_start < col_end ? ((1u << col_end) - 1) & ~((1u << col_start) - 1) : 0;
+                for (int r = row_start; r < row_end; ++r) {
+                    uint8_t* dst = surface.pixels.data() + (size_t)(pen_y + r) * surface.pitch + pen_x;
+                    for (unsigned bits = glyph[r] & col_mask; bits; bits &= bits - 1) {
+                        dst[__builtin_ctz(bits)] = run.color;
+                    }
                 }
             }
+            pen_x += glyph_size;
         }
-        x += 9; // Move to next character position
     }
-    
-    SDL_UnlockSurface(surface);
 }
 
 int main(int argc, char** args) {
     
     bool quit = false;
     SDL_Surface* surface = NULL;
+    SDL_Surface* window_surface = NULL;
     SDL_Window* window = NULL;
     SDL_Event event;
 
@@ -129,22 +330,36 @@ int main(int argc, char** args) {
         return 1;
     }
 
-    surface = SDL_GetWindowSurface(window);
+    window_surface = SDL_GetWindowSurface(window);
 
-    if (!surface) {
+    if (!window_surface) {
         cout << "Error getting surface: " << SDL_GetError() << endl;
         return 1;
     }
 
     // Convert to ARGB8888 format for consistent pixel manipulation
-    surface = SDL_ConvertSurface(surface, SDL_PIXELFORMAT_ARGB8888);
+    surface = SDL_ConvertSurface(window_surface, SDL_PIXELFORMAT_ARGB8888);
+
+    if (!surface) {
+        cout << "Error converting surface: " << SDL_GetError() << endl;
+        return 1;
+    }
+    
+    // All drawing goes to the 8-bit indexed surface, like VGA memory at A000:0000
+    IndexedSurface vga_memory(surface->w, surface->h);
 
     cout << "VGA Mode 13h Equivalent Demo" << endl;
     cout << "Resolution: " << surface->w << "x" << surface->h << endl;
     cout << "Emulating 256-color palette" << endl;
     cout << "Press ESC or close window to exit" << endl;
 
-    uint64_t start_time = SDL_GetTicks();
+    // Draw the plasma and title once; animation is done purely by palette cycling
+    draw_plasma_effect(vga_memory, 0.0);
+    const TextRun title[] = {
+        {10, 10, "VGA MODE 13h DEMO", 15},  // White text
+        {10, 25, "320x200 256 COLORS", 14}, // Yellow text
+    };
+    draw_text_runs(vga_memory, title, sizeof(title) / sizeof(title[0]));
     
     while (!quit) {
         while (SDL_PollEvent(&event)) {
@@ -158,19 +373,17 @@ int main(int argc, char** args) {
             }
         }
         
-        double time = (SDL_GetTicks() - start_time) / 1000.0;
-        
-        // Draw animated plasma effect (classic VGA demo style)
-        draw_plasma_effect(surface, time);
-        
-        // Draw title text
-        draw_text(surface, "VGA MODE 13h DEMO", 10, 10, 15); // White text
-        draw_text(surface, "320x200 256 COLORS", 10, 25, 14); // Yellow text
+        // Cycle the gradient entries (EGA colors 0-15 used by the text stay fixed)
+        vga_palette.rotate(16, 240);
         
+        // Expand indices to ARGB at present time
+        resolve_indexed(vga_memory, vga_palette, surface);
+        SDL_BlitSurface(surface, NULL, window_surface, NULL);
         SDL_UpdateWindowSurface(window);
         SDL_Delay(16); // ~60 FPS
     }
 
+    SDL_DestroySurface(surface);
     SDL_DestroyWindow(window);
     SDL_Quit();
 
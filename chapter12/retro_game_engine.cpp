@@ -194,16 +194,52 @@ struct Tilemap {
     }
 };
 
+// Fixed-step accumulator from chapter7/sprite_animation.cpp; the engine
+// steps updateGame at 240 Hz and renders at alpha() between the last two steps
+class FixedTimestep {
+public:
+    FixedTimestep(double stepHz, int maxStepsPerFrame = 8)
+        : step(1.0 / stepHz), maxSteps(maxStepsPerFrame) {}
+
+    // Adds one frame's real time and returns how many steps to simulate
+    int advance(double frameSeconds) {
+        accumulator += max(0.0, frameSeconds);
+        int steps = (int)(accumulator / step);
+        if (steps > maxSteps) {
+            droppedSeconds += (steps - maxSteps) * step;
+            steps = maxSteps;
+        }
+        accumulator = fmod(accumulator, step);
+        return steps;
+    }
+
+    double getStep() const { return step; }
+    double alpha() const { return accumulator / step; }
+    double getDroppedSeconds() const { return droppedSeconds; }
+
+private:
+    double step;
+    int maxSteps;
+    double accumulator = 0.0;
+    double droppedSeconds = 0.0;
+};
+
 // Book's sprite system
 struct Sprite {
     float x, y;
+    float prevX, prevY;  // position before the latest simulation step
     float dx, dy;
     int width, height;
     uint32_t color;
     bool active;
     
     Sprite(float px, float py, int w, int h, uint32_t c) 
-        : x(px), y(py), dx(0), dy(0), width(w), height(h), color(c), active(true) {}
+        : x(px), y(py), prevX(px), prevY(py), dx(0), dy(0), width(w), height(h), color(c), active(true) {}
+    
+    void savePrevious() {
+        prevX = x;
+        prevY = y;
+    }
     
     void update(float deltaTime) {
         if (!active) return;
@@ -212,10 +248,13 @@ struct Sprite {
         y += dy * deltaTime;
     }
     
-    void render(SoftwareSurface* surface) {
+    // Draws at the position alpha of the way from the previous step to the latest one
+    void render(SoftwareSurface* surface, float alpha = 1.0f) {
         if (!active) return;
         
-        drawRect(surface, (int)x, (int)y, width, height, color);
+        int drawX = (int)lround(prevX + (x - prevX) * alpha);
+        int drawY = (int)lround(prevY + (y - prevY) * alpha);
+        drawRect(surface, drawX, drawY, width, height, color);
     }
     
     bool collidesWith(const Sprite& other) const {
@@ -241,7 +280,12 @@ private:
     vector<Sprite> bullets;
     
     bool running;
-    uint32_t lastTime;
+    uint64_t lastTime;       // SDL_GetTicksNS() at the previous frame
+    FixedTimestep timestep;  // simulation runs at its own fixed rate
+    double simTime;          // seconds simulated so far, the sum of all steps
+    double lastShotTime;     // simTime of the last shot
+
+    static constexpr double SHOT_COOLDOWN = 0.2;  // seconds of simulated time
     
     // Input state
     bool keys[512]; // Increased size for SDL3 keycodes
@@ -250,7 +294,7 @@ public:
     RetroGameEngine(int width, int height) 
         : window(nullptr), renderer(nullptr), texture(nullptr),
           player(width/2, height/2, 16, 16, createColor(255, 255, 0)), // Yellow player
-          running(false), lastTime(0) {
+          running(false), lastTime(0), timestep(240.0), simTime(0.0), lastShotTime(-SHOT_COOLDOWN) {
         
         memset(keys, 0, sizeof(keys));
         
@@ -296,7 +340,7 @@ public:
         }
         
         running = true;
-        lastTime = SDL_GetTicks();
+        lastTime = SDL_GetTicksNS();
         
         cout << "Retro game engine initialized with CPU-only rendering" << endl;
     }
@@ -331,7 +375,13 @@ public:
         }
     }
     
+    // One fixed simulation step
     void updateGame(float deltaTime) {
+        simTime += deltaTime;
+        player.savePrevious();
+        for (auto& enemy : enemies) enemy.savePrevious();
+        for (auto& bullet : bullets) bullet.savePrevious();
+        
         // Player movement
         const float speed = 200.0f;
         if (keys[SDLK_W] || keys[SDLK_UP]) player.y -= speed * deltaTime;
@@ -343,12 +393,11 @@ public:
         player.x = max(0.0f, min((float)(framebuffer->width - player.width), player.x));
         player.y = max(0.0f, min((float)(framebuffer->height - player.height), player.y));
         
-        // Shooting
-        static uint32_t lastShot = 0;
-        if (keys[SDLK_SPACE] && SDL_GetTicks() - lastShot > 200) {
+        // Shooting, rate-limited in simulated time so it matches the step rate
+        if (keys[SDLK_SPACE] && simTime - lastShotTime >= SHOT_COOLDOWN) {
             bullets.emplace_back(player.x + player.width/2, player.y, 4, 8, createColor(255, 255, 255));
             bullets.back().dy = -400; // Move upward
-            lastShot = SDL_GetTicks();
+            lastShotTime = simTime;
         }
         
         // Update enemies
@@ -410,7 +459,7 @@ public:
         }
     }
     
-    void render() {
+    void render(float alpha) {
         // Clear framebuffer (CPU operation)
         framebuffer->clear(createColor(32, 32, 64)); // Dark blue background
         
@@ -418,14 +467,14 @@ public:
         tilemap->render(framebuffer.get());
         
         // Render sprites (CPU drawing)
-        player.render(framebuffer.get());
+        player.render(framebuffer.get(), alpha);
         
         for (auto& enemy : enemies) {
-            enemy.render(framebuffer.get());
+            enemy.render(framebuffer.get(), alpha);
         }
         
         for (auto& bullet : bullets) {
-            bullet.render(framebuffer.get());
+            bullet.render(framebuffer.get(), alpha);
         }
         
         // Draw UI
@@ -453,13 +502,14 @@ public:
         cout << "Target: Destroy all red enemies!" << endl;
         
         while (running) {
-            uint32_t currentTime = SDL_GetTicks();
-            float deltaTime = (currentTime - lastTime) / 1000.0f;
+            uint64_t currentTime = SDL_GetTicksNS();
+            double frameSeconds = (currentTime - lastTime) / 1e9;
             lastTime = currentTime;
             
             handleInput();
-            updateGame(deltaTime);
-            render();
+            int steps = timestep.advance(frameSeconds);
+            for (int i = 0; i < steps; ++i) updateGame((float)timestep.getStep());
+            render((float)timestep.alpha());
             
             // Cap frame rate to ~60 FPS
             SDL_Delay(16);
@@ -0,0 +1,330 @@
+//Chapter 2: Setting Up Your Environment - Streaming Solid and Gradient Fill Kernels
+//Standard C++ libraries
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <unistd.h>
+
+//SIMD intrinsics
+#include <immintrin.h>  // AVX2 + non-temporal stores (falls back to scalar when unavailable)
+
+using namespace std;
+using namespace std::chrono;
+
+// Pitch-aware ARGB8888 surface (pitch in pixels), same layout as SDL_Surface
+struct FillSurface {
+    uint32_t* pixels;
+    int width;
+    int height;
+    int pitch;
+};
+
+// How row stores are issued
+enum class StoreMode {
+    Auto,      // stream only when the buffer would not fit in the last-level cache
+    Cached,    // regular stores, result stays in cache for the next pass
+    Streaming  // non-temporal stores, bypass the cache entirely
+};
+
+// Size of the last-level cache, used to decide when streaming stores pay off
+size_t lastLevelCacheBytes() {
+    static size_t cached = 0;
+    if (cached == 0) {
+#ifdef _SC_LEVEL3_CACHE_SIZE
+        long l3 = sysconf(_SC_LEVEL3_CACHE_SIZE);
+        if (l3 > 0) cached = (size_t)l3;
+#endif
+        if (cached == 0) cached = 8 * 1024 * 1024; // conservative default
+    }
+    return cached;
+}
+
+static bool useStreaming(const FillSurface& surface, StoreMode mode) {
+    if (mode == StoreMode::Auto) {
+        return (size_t)surface.pitch * surface.height * sizeof(uint32_t) > lastLevelCacheBytes();
+    }
+    return mode == StoreMode::Streaming;
+}
+
+// Fill one row with a constant color
+static inline void fillRow(uint32_t* dst, int count, uint32_t color, bool streaming) {
+    int x = 0;
+#ifdef __AVX2__
+    __m256i colorVec = _mm256_set1_epi32((int)color);
+    if (streaming) {
+        // Non-temporal stores need 32-byte alignment: scalar head, streamed body
+        for (; x < count && ((uintptr_t)(dst + x) & 31); ++x) dst[x] = color;
+        for (; x + 16 <= count; x += 16) {
+            _mm256_stream_si256((__m256i*)(dst + x), colorVec);
+            _mm256_stream_si256((__m256i*)(dst + x + 8), colorVec);
+        }
+    } else {
+        for (; x + 16 <= count; x += 16) {
+            _mm256_storeu_si256((__m256i*)(dst + x), colorVec);
+            _mm256_storeu_si256((__m256i*)(dst + x + 8), colorVec);
+        }
+    }
+#else
+    (void)streaming;
+#endif
+    for (; x < count; ++x) dst[x] = color;
+}
+
+// Copy a precomputed row template, optionally adding a per-row color (saturating)
+static inline void writeTemplateRow(uint32_t* dst, const uint32_t* tmpl, int count,
+                                    uint32_t rowColor, bool streaming) {
+    int x = 0;
+#ifdef __AVX2__
+    __m256i rowVec = _mm256_set1_epi32((int)rowColor);
+    if (streaming) {
+        for (; x < count && ((uintptr_t)(dst + x) & 31); ++x) {
+            __m128i p = _mm_adds_epu8(_mm_cvtsi32_si128((int)tmpl[x]), _mm_cvtsi32_si128((int)rowColor));
+            dst[x] = (uint32_t)_mm_cvtsi128_si32(p);
+        }
+        for (; x + 8 <= count; x += 8) {
+            __m256i t = _mm256_loadu_si256((const __m256i*)(tmpl + x));
+            _mm256_stream_si256((__m256i*)(dst + x), _mm256_adds_epu8(t, rowVec));
+        }
+    } else {
+        for (; x + 8 <= count; x += 8) {
+            __m256i t = _mm256_loadu_si256((const __m256i*)(tmpl + x));
+            _mm256_storeu_si256((__m256i*)(dst + x), _mm256_adds_epu8(t, rowVec));
+        }
+    }
+#else
+    (void)streaming;
+#endif
+    for (; x < count; ++x) {
+        uint32_t out = 0;
+        for (int shift = 0; shift < 32; shift += 8) {
+            uint32_t c = ((tmpl[x] >> shift) & 0xFF) + ((rowColor >> shift) & 0xFF);
+            out |= min(c, 255u) << shift;
+        }
+        dst[x] = out;
+    }
+}
+
+// Solid fill of the whole surface, honoring pitch padding
+void fillSolid(const FillSurface& surface, uint32_t color, StoreMode mode = StoreMode::Auto) {
+    bool streaming = useStreaming(surface, mode);
+    for (int y = 0; y < surface.height; ++y) {
+        fillRow(surface.pixels + (size_t)y * surface.pitch, surface.width, color, streaming);
+    }
+#ifdef __AVX2__
+    if (streaming) _mm_sfence(); // make streamed data globally visible before present
+#endif
+}
+
+// Per-channel DDA in 32.32 fixed point: value(i) = c0 + floor(i * (c1 - c0) / steps)
+// for each of the four bytes, without a single divide inside the loop.
+// The step is rounded up so the result matches the integer division exactly
+// for any run shorter than 65536 pixels.
+static void gradientDDA(uint32_t* out, int count, int steps, uint32_t c0, uint32_t c1) {
+    int64_t value[4], step[4];
+    for (int ch = 0; ch < 4; ++ch) {
+        int shift = ch * 8;
+        int64_t start = (c0 >> shift) & 0xFF;
+        int64_t delta = (int64_t)((c1 >> shift) & 0xFF) - start;
+        value[ch] = start << 32;
+        // One divide per channel per call, never per pixel
+        step[ch] = delta >= 0 ? ((delta << 32) + steps - 1) / steps
+                              : -((((-delta) << 32)) / steps);
+    }
+    for (int i = 0; i < count; ++i) {
+        out[i] = (uint32_t)((value[3] >> 32) << 24 | (value[2] >> 32) << 16 |
+                            (value[1] >> 32) << 8 | (value[0] >> 32));
+        for (int ch = 0; ch < 4; ++ch) value[ch] += step[ch];
+    }
+}
+
+// Linear gradient from c0 to c1 along x (horizontal) or y (vertical)
+void fillLinearGradient(const FillSurface& surface, uint32_t c0, uint32_t c1, bool horizontal,
+                        StoreMode mode = StoreMode::Auto) {
+    bool streaming = useStreaming(surface, mode);
+    if (horizontal) {
+        // Every row is the same: step the DDA once, then copy the template down
+        vector<uint32_t> row(surface.width);
+        gradientDDA(row.data(), surface.width, surface.width, c0, c1);
+        for (int y = 0; y < surface.height; ++y) {
+            writeTemplateRow(surface.pixels + (size_t)y * surface.pitch, row.data(),
+                             surface.width, 0, streaming);
+        }
+    } else {
+        // Every row is a solid color: step the DDA down the rows
+        vector<uint32_t> column(surface.height);
+        gradientDDA(column.data(), surface.height, surface.height, c0, c1);
+        for (int y = 0; y < surface.height; ++y) {
+            fillRow(surface.pixels + (size_t)y * surface.pitch, surface.width, column[y], streaming);
+        }
+    }
+#ifdef __AVX2__
+    if (streaming) _mm_sfence();
+#endif
+}
+
+// 2D gradient: per-channel sum (saturating) of an x ramp and a y ramp.
+// The x ramp is stepped once into a row template; each row then adds its
+// y color with one saturating byte add per 8 pixels.
+void fillGradient2D(const FillSurface& surface,
+                    uint32_t xStart, uint32_t xEnd, uint32_t yStart, uint32_t yEnd,
+                    StoreMode mode = StoreMode::Auto) {
+    bool streaming = useStreaming(surface, mode);
+    vector<uint32_t> row(surface.width);
+    vector<uint32_t> column(surface.height);
+    gradientDDA(row.data(), surface.width, surface.width, xStart, xEnd);
+    gradientDDA(column.data(), surface.height, surface.height, yStart, yEnd);
+
+    for (int y = 0; y < surface.height; ++y) {
+        writeTemplateRow(surface.pixels + (size_t)y * surface.pitch, row.data(),
+                         surface.width, column[y], streaming);
+    }
+#ifdef __AVX2__
+    if (streaming) _mm_sfence();
+#endif
+}
+
+// Book's direct_fill_blue / direct_fill_gradient loops (chapter2/direct_access.cpp)
+void direct_fill_blue_reference(const FillSurface& surface) {
+    for (int y = 0; y < surface.height; ++y) {
+        for (int x = 0; x < surface.width; ++x) {
+            surface.pixels[y * surface.pitch + x] = 0xFF0000FF;
+        }
+    }
+}
+
+void direct_fill_gradient_reference(const FillSurface& surface) {
+    for (int y = 0; y < surface.height; ++y) {
+        for (int x = 0; x < surface.width; ++x) {
+            uint8_t r = (x * 255) / surface.width;
+            uint8_t g = (y * 255) / surface.height;
+            uint8_t b = 128;
+            uint32_t color = 0xFF000000 | (r << 16) | (g << 8) | b;
+            surface.pixels[y * surface.pitch + x] = color;
+        }
+    }
+}
+
+// Equivalent of direct_fill_gradient: red follows x, green follows y
+void fillDirectGradient(const FillSurface& surface, StoreMode mode = StoreMode::Auto) {
+    fillGradient2D(surface, 0x00000000, 0x00FF0000, 0xFF000080, 0xFF00FF80, mode);
+}
+
+// 32-byte aligned, pitch-padded test buffer
+struct AlignedBuffer {
+    uint32_t* data;
+    FillSurface surface;
+
+    AlignedBuffer(int width, int height, int padPixels) {
+        int pitch = width + padPixels;
+        size_t bytes = (size_t)pitch * height * sizeof(uint32_t);
+        data = (uint32_t*)aligned_alloc(64, (bytes + 63) & ~(size_t)63);
+        memset(data, 0xAB, bytes);
+        surface = {data, width, height, pitch};
+    }
+
+    ~AlignedBuffer() { free(data); }
+};
+
+template <typename Fn>
+double timeMs(int iterations, Fn fn) {
+    auto start = high_resolution_clock::now();
+    for (int i = 0; i < iterations; ++i) fn();
+    return duration<double, milli>(high_resolution_clock::now() - start).count() / iterations;
+}
+
+bool sameVisiblePixels(const FillSurface& a, const FillSurface& b) {
+    for (int y = 0; y < a.height; ++y) {
+        if (memcmp(a.pixels + (size_t)y * a.pitch, b.pixels + (size_t)y * b.pitch,
+                   a.width * sizeof(uint32_t)) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool paddingUntouched(const FillSurface& s) {
+    for (int y = 0; y < s.height; ++y) {
+        for (int x = s.width; x < s.pitch; ++x) {
+            if (s.pixels[(size_t)y * s.pitch + x] != 0xABABABAB) return false;
+        }
+    }
+    return true;
+}
+
+void benchmarkResolution(const char* name, int width, int height) {
+    const int iterations = max(5, (int)(200000000LL / ((long long)width * height * 4)));
+    AlignedBuffer ref(width, height, 0);
+    AlignedBuffer out(width, height, 0);
+    double mb = (double)width * height * 4 / (1024 * 1024);
+
+    cout << "\n=== " << name << " (" << width << "x" << height << ", "
+         << fixed << setprecision(1) << mb << " MB) ===" << endl;
+
+    double refSolid = timeMs(iterations, [&] { direct_fill_blue_reference(ref.surface); });
+    double cachedSolid = timeMs(iterations, [&] { fillSolid(out.surface, 0xFF0000FF, StoreMode::Cached); });
+    double streamSolid = timeMs(iterations, [&] { fillSolid(out.surface, 0xFF0000FF, StoreMode::Streaming); });
+    bool solidOk = sameVisiblePixels(ref.surface, out.surface);
+
+    double refGrad = timeMs(iterations, [&] { direct_fill_gradient_reference(ref.surface); });
+    double cachedGrad = timeMs(iterations, [&] { fillDirectGradient(out.surface, StoreMode::Cached); });
+    double streamGrad = timeMs(iterations, [&] { fillDirectGradient(out.surface, StoreMode::Streaming); });
+    bool gradOk = sameVisiblePixels(ref.surface, out.surface);
+
+    auto report = [&](const char* label, double ms, double baseline) {
+        cout << "  " << left << setw(34) << label << right << setprecision(3) << setw(8) << ms << " ms  "
+             << setprecision(1) << setw(7) << mb / 1024 / (ms / 1000) << " GB/s  "
+             << setprecision(2) << baseline / ms << "x" << endl;
+    };
+    report("direct_fill_blue (scalar loop)", refSolid, refSolid);
+    report("fillSolid, cached AVX2 stores", cachedSolid, refSolid);
+    report("fillSolid, streaming stores", streamSolid, refSolid);
+    cout << "  Solid fill verification: " << (solidOk ? "✓ PASSED" : "✗ FAILED") << endl;
+    report("direct_fill_gradient (2 divs/px)", refGrad, refGrad);
+    report("fillGradient2D, cached", cachedGrad, refGrad);
+    report("fillGradient2D, streaming", streamGrad, refGrad);
+    cout << "  Gradient verification: " << (gradOk ? "✓ PASSED (bit-exact)" : "✗ FAILED") << endl;
+    cout << "  Auto mode would " << (useStreaming(out.surface, StoreMode::Auto) ? "stream" : "use cached stores")
+         << " (LLC " << lastLevelCacheBytes() / (1024 * 1024) << " MB)" << endl;
+}
+
+void verifyPitchHandling() {
+    // Odd width and padded pitch: kernels must never write into the padding
+    AlignedBuffer ref(333, 77, 11);
+    AlignedBuffer out(333, 77, 11);
+    direct_fill_gradient_reference(ref.surface);
+    fillDirectGradient(out.surface, StoreMode::Streaming);
+    bool ok = sameVisiblePixels(ref.surface, out.surface) && paddingUntouched(out.surface);
+
+    fillSolid(out.surface, 0xFF123456, StoreMode::Streaming);
+    ok = ok && paddingUntouched(out.surface);
+    fillLinearGradient(out.surface, 0xFF000000, 0xFFFFFFFF, false, StoreMode::Cached);
+    ok = ok && paddingUntouched(out.surface) &&
+         out.surface.pixels[0] == 0xFF000000 &&
+         out.surface.pixels[(size_t)76 * out.surface.pitch] == 0xFFFBFBFB;
+
+    cout << "Pitch-padded surface verification: " << (ok ? "✓ PASSED" : "✗ FAILED") << endl;
+}
+
+int main(int argc, char** args) {
+    cout << "=== Chapter 2: Streaming Solid and Gradient Fill Kernels ===" << endl;
+    cout << "Store path: ";
+#ifdef __AVX2__
+    cout << "AVX2 (_mm256_storeu_si256 / _mm256_stream_si256)" << endl;
+#else
+    cout << "scalar (compile with -march=native for AVX2)" << endl;
+#endif
+
+    verifyPitchHandling();
+    benchmarkResolution("720p", 1280, 720);
+    benchmarkResolution("1080p", 1920, 1080);
+    benchmarkResolution("4K", 3840, 2160);
+
+    cout << "\nStreaming stores win once the frame no longer fits in the LLC;" << endl;
+    cout << "below that, cached stores keep the frame hot for the next drawing pass." << endl;
+    return 0;
+}
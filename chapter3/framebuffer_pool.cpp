@@ -0,0 +1,488 @@
+//Chapter 3: Memory and Pixels - Pooled, Huge-Page-Backed Framebuffer Allocator
+//Standard C++ libraries
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include <fstream>
+#include <string>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <cstdio>
+#include <algorithm>
+
+//POSIX / Linux memory APIs
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/ioctl.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#include <linux/perf_event.h>
+
+using namespace std;
+using namespace std::chrono;
+
+constexpr size_t CACHE_LINE = 64;
+constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+// Where framebuffer memory comes from
+enum class PageBacking {
+    Regular,        // posix_memalign, 4 KB pages
+    TransparentHuge, // 2 MB aligned mmap + madvise(MADV_HUGEPAGE)
+    HugeTLB         // mmap(MAP_HUGETLB), falls back to TransparentHuge if no pages are reserved
+};
+
+const char* backingName(PageBacking backing) {
+    switch (backing) {
+        case PageBacking::Regular: return "4 KB pages";
+        case PageBacking::TransparentHuge: return "THP (madvise)";
+        case PageBacking::HugeTLB: return "MAP_HUGETLB";
+    }
+    return "?";
+}
+
+// Pitch in pixels: rows start on a cache line, and a pitch that is an exact
+// multiple of 4 KB gets one extra line so vertically adjacent pixels do not
+// alias in the L1 cache sets
+int paddedPitch(int width) {
+    size_t bytes = ((size_t)width * sizeof(uint32_t) + CACHE_LINE - 1) & ~(CACHE_LINE - 1);
+    if (bytes % 4096 == 0) bytes += CACHE_LINE;
+    return (int)(bytes / sizeof(uint32_t));
+}
+
+struct PoolStats {
+    size_t acquires = 0;        // acquire() calls
+    size_t poolHits = 0;        // served from a recycled block
+    size_t systemAllocs = 0;    // posix_memalign / mmap calls
+    size_t systemFrees = 0;
+    size_t hugeTLBFallbacks = 0;
+    size_t bytesReserved = 0;   // currently owned by the pool (in use + cached)
+    size_t peakBytesReserved = 0;
+};
+
+class FramebufferPool;
+
+// Handle to a pooled framebuffer; returns the memory to the pool when destroyed
+class PooledFramebuffer {
+public:
+    PooledFramebuffer() = default;
+    PooledFramebuffer(const PooledFramebuffer&) = delete;
+    PooledFramebuffer& operator=(const PooledFramebuffer&) = delete;
+    PooledFramebuffer(PooledFramebuffer&& other) noexcept { *this = std::move(other); }
+    PooledFramebuffer& operator=(PooledFramebuffer&& other) noexcept;
+    ~PooledFramebuffer() { release(); }
+
+    void release();
+
+    uint32_t* pixels = nullptr;
+    int width = 0;
+    int height = 0;
+    int pitch = 0; // in pixels
+
+    uint32_t* row(int y) { return pixels + (size_t)y * pitch; }
+
+private:
+    friend class FramebufferPool;
+    FramebufferPool* owner = nullptr;
+    size_t capacity = 0;
+    bool mapped = false; // came from mmap, must be munmap'ed
+};
+
+class FramebufferPool {
+public:
+    explicit FramebufferPool(PageBacking backing = PageBacking::Regular,
+                             size_t maxCachedBytes = 256 * 1024 * 1024)
+        : backing(backing), maxCachedBytes(maxCachedBytes) {}
+
+    // The pool must outlive every buffer it handed out: a buffer released
+    // later would return its block to a destroyed pool. Checked in release
+    // builds too, since that bug is a silent use-after-free otherwise.
+    ~FramebufferPool() {
+        if (outstanding != 0) {
+            cerr << "FramebufferPool destroyed with " << outstanding
+                 << " buffer(s) still in use" << endl;
+            abort();
+        }
+        trim();
+    }
+
+    // Hand out a 64-byte aligned, pitch-padded buffer. Contents are undefined.
+    PooledFramebuffer acquire(int width, int height) {
+        PooledFramebuffer fb;
+        fb.width = width;
+        fb.height = height;
+        fb.pitch = paddedPitch(width);
+        size_t needed = (size_t)fb.pitch * height * sizeof(uint32_t);
+        stats.acquires++;
+
+        // Best fit among cached blocks, but never waste more than half a block.
+        // The free list holds a handful of blocks, so a linear scan beats a tree.
+        size_t best = freeBlocks.size();
+        for (size_t i = 0; i < freeBlocks.size(); ++i) {
+            size_t cap = freeBlocks[i].capacity;
+            if (cap >= needed && cap <= needed * 2 && (best == freeBlocks.size() || cap < freeBlocks[best].capacity)) best = i;
+        }
+        if (best != freeBlocks.size()) {
+            const Block& block = freeBlocks[best];
+            fb.pixels = (uint32_t*)block.pixels;
+            fb.capacity = block.capacity;
+            fb.mapped = block.mapped;
+            cachedBytes -= block.capacity;
+            freeBlocks[best] = freeBlocks.back();
+            freeBlocks.pop_back();
+            stats.poolHits++;
+        } else {
+            fb.capacity = roundCapacity(needed);
+            fb.pixels = (uint32_t*)systemAllocate(fb.capacity, fb.mapped);
+        }
+        fb.owner = fb.pixels ? this : nullptr;
+        if (fb.pixels) outstanding++;
+        return fb;
+    }
+
+    // Drop every cached block (e.g. after a window resize settles)
+    void trim() {
+        for (const Block& block : freeBlocks) systemFree(block.pixels, block.capacity, block.mapped);
+        freeBlocks.clear();
+        cachedBytes = 0;
+    }
+
+    const PoolStats& getStats() const { return stats; }
+    PageBacking getBacking() const { return backing; }
+
+private:
+    friend class PooledFramebuffer;
+
+    PageBacking backing;
+    size_t maxCachedBytes;
+    size_t cachedBytes = 0;
+    struct Block {
+        void* pixels;
+        size_t capacity;
+        bool mapped;
+    };
+    vector<Block> freeBlocks;
+    size_t outstanding = 0; // buffers handed out and not yet released
+    PoolStats stats;
+
+    size_t roundCapacity(size_t bytes) const {
+        if (backing == PageBacking::Regular) {
+            return (bytes + 4095) & ~(size_t)4095;
+        }
+        return (bytes + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1);
+    }
+
+    void recycle(void* block, size_t capacity, bool mapped) {
+        outstanding--;
+        if (cachedBytes + capacity > maxCachedBytes) {
+            systemFree(block, capacity, mapped);
+            return;
+        }
+        freeBlocks.push_back({block, capacity, mapped});
+        cachedBytes += capacity;
+    }
+
+    void* systemAllocate(size_t capacity, bool& isMapped) {
+        void* block = nullptr;
+        isMapped = false;
+
+        if (backing == PageBacking::HugeTLB) {
+            void* p = mmap(nullptr, capacity, PROT_READ | PROT_WRITE,
+                           MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+            if (p != MAP_FAILED) {
+                block = p;
+                isMapped = true;
+            } else {
+                stats.hugeTLBFallbacks++;
+            }
+        }
+
+        if (!block && backing != PageBacking::Regular) {
+            // Over-map by one huge page so the block can start on a 2 MB boundary
+            size_t span = capacity + HUGE_PAGE_SIZE;
+            void* p = mmap(nullptr, span, PROT_READ | PROT_WRITE,
+                           MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (p != MAP_FAILED) {
+                uintptr_t base = (uintptr_t)p;
+                uintptr_t aligned = (base + HUGE_PAGE_SIZE - 1) & ~(uintptr_t)(HUGE_PAGE_SIZE - 1);
+                if (aligned > base) munmap(p, aligned - base);
+                size_t tail = (base + span) - (aligned + capacity);
+                if (tail > 0) munmap((void*)(aligned + capacity), tail);
+                block = (void*)aligned;
+                isMapped = true;
+#ifdef MADV_HUGEPAGE
+                madvise(block, capacity, MADV_HUGEPAGE);
+#endif
+            }
+        }
+
+        if (!block && posix_memalign(&block, CACHE_LINE, capacity) != 0) {
+            return nullptr;
+        }
+
+        stats.systemAllocs++;
+        stats.bytesReserved += capacity;
+        stats.peakBytesReserved = max(stats.peakBytesReserved, stats.bytesReserved);
+        return block;
+    }
+
+    void systemFree(void* block, size_t capacity, bool mapped) {
+        if (mapped) {
+            munmap(block, capacity);
+        } else {
+            free(block);
+        }
+        stats.systemFrees++;
+        stats.bytesReserved -= capacity;
+    }
+};
+
+PooledFramebuffer& PooledFramebuffer::operator=(PooledFramebuffer&& other) noexcept {
+    if (this != &other) {
+        release();
+        pixels = other.pixels;
+        width = other.width;
+        height = other.height;
+        pitch = other.pitch;
+        owner = other.owner;
+        capacity = other.capacity;
+        mapped = other.mapped;
+        other.pixels = nullptr;
+        other.owner = nullptr;
+    }
+    return *this;
+}
+
+void PooledFramebuffer::release() {
+    if (owner && pixels) owner->recycle(pixels, capacity, mapped);
+    pixels = nullptr;
+    owner = nullptr;
+}
+
+// dTLB load-miss counter via perf_event_open (unavailable in many containers)
+class TLBMissCounter {
+public:
+    TLBMissCounter() {
+        perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HW_CACHE;
+        attr.config = PERF_COUNT_HW_CACHE_DTLB |
+                      (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                      (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd = (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+    }
+
+    ~TLBMissCounter() { if (fd >= 0) close(fd); }
+
+    bool available() const { return fd >= 0; }
+
+    void start() {
+        if (fd < 0) return;
+        ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+
+    long long stop() {
+        if (fd < 0) return -1;
+        ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+        long long count = 0;
+        if (read(fd, &count, sizeof(count)) != sizeof(count)) return -1;
+        return count;
+    }
+
+private:
+    int fd = -1;
+};
+
+string transparentHugePageMode() {
+    ifstream file("/sys/kernel/mm/transparent_hugepage/enabled");
+    string line;
+    if (!getline(file, line)) return "unknown";
+    size_t open = line.find('['), close = line.find(']');
+    return (open != string::npos && close != string::npos) ? line.substr(open + 1, close - open - 1) : line;
+}
+
+// Huge pages backing the mapping that contains addr (-1 if unknown)
+long hugePageKB(const void* addr) {
+    ifstream file("/proc/self/smaps");
+    string line;
+    bool inMapping = false;
+    uintptr_t target = (uintptr_t)addr;
+    while (getline(file, line)) {
+        unsigned long start, end;
+        if (sscanf(line.c_str(), "%lx-%lx", &start, &end) == 2 && line.find(':') > line.find(' ')) {
+            inMapping = target >= start && target < end;
+        } else if (inMapping && line.compare(0, 14, "AnonHugePages:") == 0) {
+            return atol(line.c_str() + 14);
+        }
+    }
+    return -1;
+}
+
+// Minor page faults so far (first touch of freshly mapped memory)
+long minorFaults() {
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_minflt;
+}
+
+// Column-major walk: every access lands on a different row, so with 4 KB
+// pages each step of a 4K frame touches a new page
+uint64_t columnWalk(PooledFramebuffer& fb) {
+    uint64_t sum = 0;
+    for (int x = 0; x < fb.width; x += 16) {
+        for (int y = 0; y < fb.height; ++y) {
+            sum += fb.pixels[(size_t)y * fb.pitch + x];
+        }
+    }
+    return sum;
+}
+
+void benchmarkTLB(PageBacking backing, TLBMissCounter& counter) {
+    FramebufferPool pool(backing);
+    PooledFramebuffer fb = pool.acquire(3840, 2160);
+    if (!fb.pixels) {
+        cout << "  " << backingName(backing) << ": allocation failed" << endl;
+        return;
+    }
+    for (int y = 0; y < fb.height; ++y) {
+        fill(fb.row(y), fb.row(y) + fb.width, (uint32_t)y);
+    }
+
+    const int passes = 10;
+    volatile uint64_t sink = 0;
+    counter.start();
+    auto start = high_resolution_clock::now();
+    for (int i = 0; i < passes; ++i) sink = sink + columnWalk(fb);
+    double ms = duration<double, milli>(high_resolution_clock::now() - start).count() / passes;
+    long long misses = counter.stop();
+
+    cout << "  " << left << setw(16) << backingName(backing) << right << fixed << setprecision(3)
+         << setw(8) << ms << " ms/pass";
+    if (misses >= 0) {
+        cout << ", " << setw(10) << misses / passes << " dTLB misses/pass";
+    }
+    long hugeKB = hugePageKB(fb.pixels);
+    if (hugeKB >= 0) cout << ", " << setprecision(1) << hugeKB / 1024.0 << " MB in huge pages";
+    cout << (pool.getStats().hugeTLBFallbacks ? "  (no reserved huge pages, used THP)" : "") << endl;
+}
+
+// Simulated window resize storm plus transient offscreen layers each frame
+template <typename AcquireFn>
+double resizeStorm(int frames, AcquireFn acquireLayers) {
+    auto start = high_resolution_clock::now();
+    for (int f = 0; f < frames; ++f) {
+        int w = 1280 + (f % 24) * 16; // user dragging the window edge back and forth
+        int h = 720 + (f % 24) * 9;
+        acquireLayers(w, h);
+    }
+    return duration<double, milli>(high_resolution_clock::now() - start).count() / frames;
+}
+
+int main(int argc, char** args) {
+    cout << "=== Chapter 3: Pooled, Huge-Page-Backed Framebuffer Allocator ===" << endl;
+    cout << "Transparent huge pages: " << transparentHugePageMode() << endl;
+
+    // Alignment and pitch padding
+    {
+        FramebufferPool pool;
+        bool ok = true;
+        int widths[] = {1, 17, 320, 1024, 1920, 3840};
+        for (int w : widths) {
+            PooledFramebuffer fb = pool.acquire(w, 8);
+            ok = ok && ((uintptr_t)fb.pixels % CACHE_LINE == 0) &&
+                 ((fb.pitch * sizeof(uint32_t)) % CACHE_LINE == 0) &&
+                 ((fb.pitch * sizeof(uint32_t)) % 4096 != 0) && fb.pitch >= w;
+        }
+        cout << "64-byte alignment and pitch padding: " << (ok ? "✓ PASSED" : "✗ FAILED") << endl;
+        cout << "  Pitch for 1024 px rows: " << paddedPitch(1024) << " px (avoids 4 KB aliasing)" << endl;
+    }
+
+    // Recycling: the second acquire of the same size must not touch the system allocator
+    {
+        FramebufferPool pool;
+        { PooledFramebuffer a = pool.acquire(1920, 1080); }
+        { PooledFramebuffer b = pool.acquire(1920, 1080); }
+        { PooledFramebuffer c = pool.acquire(1900, 1070); } // smaller, fits the cached block
+        const PoolStats& s = pool.getStats();
+        bool ok = s.systemAllocs == 1 && s.poolHits == 2;
+        cout << "Block recycling: " << (ok ? "✓ PASSED" : "✗ FAILED") << endl;
+    }
+
+    // Resize storm: new[]/delete[] per layer vs pooled buffers
+    cout << "\n=== Resize storm: 3 offscreen layers per frame, 600 frames ===" << endl;
+    const int frames = 600;
+    size_t naiveAllocs = 0;
+    long faultsBefore = minorFaults();
+    double naiveMs = resizeStorm(frames, [&](int w, int h) {
+        for (int layer = 0; layer < 3; ++layer) {
+            uint32_t* pixels = new uint32_t[(size_t)w * h];
+            memset(pixels, 0, (size_t)w * h * sizeof(uint32_t)); // layer clear
+            naiveAllocs++;
+            delete[] pixels;
+        }
+    });
+
+    long naiveFaults = minorFaults() - faultsBefore;
+
+    FramebufferPool pool(PageBacking::TransparentHuge);
+    faultsBefore = minorFaults();
+    double pooledMs = resizeStorm(frames, [&](int w, int h) {
+        PooledFramebuffer layers[3];
+        for (int layer = 0; layer < 3; ++layer) {
+            layers[layer] = pool.acquire(w, h);
+            memset(layers[layer].pixels, 0, (size_t)layers[layer].pitch * h * sizeof(uint32_t));
+        }
+    });
+
+    long pooledFaults = minorFaults() - faultsBefore;
+
+    // Same storm without the clear: what acquire/release itself costs
+    volatile uint32_t sink = 0;
+    double naiveAllocMs = resizeStorm(frames, [&](int w, int h) {
+        for (int layer = 0; layer < 3; ++layer) {
+            uint32_t* pixels = new uint32_t[(size_t)w * h];
+            pixels[0] = layer;
+            sink = sink + pixels[0];
+            delete[] pixels;
+        }
+    });
+    double pooledAllocMs = resizeStorm(frames, [&](int w, int h) {
+        PooledFramebuffer layers[3];
+        for (int layer = 0; layer < 3; ++layer) {
+            layers[layer] = pool.acquire(w, h);
+            layers[layer].pixels[0] = layer;
+            sink = sink + layers[layer].pixels[0];
+        }
+    });
+
+    const PoolStats& s = pool.getStats();
+    cout << fixed << setprecision(3);
+    cout << "new[]/delete[] per layer: " << naiveMs << " ms/frame, " << naiveAllocs << " allocations, "
+         << naiveFaults << " page faults" << endl;
+    cout << "Pooled (THP backing):     " << pooledMs << " ms/frame, " << s.systemAllocs << " allocations, "
+         << pooledFaults << " page faults" << endl;
+    cout << "  frame time is dominated by clearing the layers; allocation alone: new[]/delete[] "
+         << naiveAllocMs * 1000 / 3 << " us, pooled " << pooledAllocMs * 1000 / 3 << " us per layer" << endl;
+    cout << "  acquires: " << s.acquires << ", pool hits: " << s.poolHits
+         << " (" << setprecision(1) << 100.0 * s.poolHits / s.acquires << "%)" << endl;
+    cout << "  reserved now: " << setprecision(2) << s.bytesReserved / (1024.0 * 1024.0)
+         << " MB, peak: " << s.peakBytesReserved / (1024.0 * 1024.0) << " MB" << endl;
+
+    // TLB pressure of a strided walk over a 4K frame
+    cout << "\n=== 3840x2160 column walk ===" << endl;
+    TLBMissCounter counter;
+    if (!counter.available()) {
+        cout << "  (perf_event_open unavailable: reporting time only)" << endl;
+    }
+    benchmarkTLB(PageBacking::Regular, counter);
+    benchmarkTLB(PageBacking::TransparentHuge, counter);
+    benchmarkTLB(PageBacking::HugeTLB, counter);
+
+    return 0;
+}
@@ -12,6 +12,13 @@ using namespace std;
 
 
 void pixel_access_demo(SDL_Surface* surface){
+  // Brightness as a 256-entry lookup table: the clamp is done once per value,
+  // not once per channel per pixel (see color_lut_transform.cpp)
+  uint8_t brighten[256];
+  for(int v = 0; v < 256; ++v){
+    brighten[v] = (uint8_t)min(255, v + 50);
+  }
+
   SDL_LockSurface(surface);
   uint32_t* pixels = (uint32_t*)surface->pixels;
   int pitch = surface->pitch / 4; // pitch in pixels, not bytes
@@ -34,9 +41,9 @@ void pixel_access_demo(SDL_Surface* surface){
       }
       
       // Manipulate pixel colors here - brighten the image
-      uint8_t new_r = min(255, (int)r + 50);
-      uint8_t new_g = min(255, (int)g + 50);
-      uint8_t new_b = min(255, (int)b + 50);
+      uint8_t new_r = brighten[r];
+      uint8_t new_g = brighten[g];
+      uint8_t new_b = brighten[b];
       
       uint32_t new_pixel = (a << 24) | (new_r << 16) | (new_g << 8) | new_b;
       pixels[y * pitch + x] = new_pixel;
@@ -0,0 +1,422 @@
+//Chapter 3: Memory and Pixels - Bulk Pixel Format Conversion
+//Standard C++ libraries
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+
+//SIMD intrinsics
+#include <immintrin.h>  // SSSE3 / AVX2 pshufb (falls back to scalar when unavailable)
+
+using namespace std;
+using namespace std::chrono;
+
+// 32-bit formats, named like SDL: the name is the channel order of the packed
+// uint32_t from most to least significant byte (little-endian memory is reversed)
+enum class Format32 {
+    ARGB8888, // memory: B G R A  (SDL_PIXELFORMAT_ARGB8888, our framebuffer format)
+    ABGR8888, // memory: R G B A  (RGBA byte order, PNG/OpenGL style)
+    BGRA8888, // memory: A R G B
+    RGBA8888  // memory: A B G R
+};
+
+// Byte offset in memory of each channel (order: R, G, B, A)
+static void channelOffsets(Format32 format, int offsets[4]) {
+    switch (format) {
+        case Format32::ARGB8888: offsets[0] = 2; offsets[1] = 1; offsets[2] = 0; offsets[3] = 3; break;
+        case Format32::ABGR8888: offsets[0] = 0; offsets[1] = 1; offsets[2] = 2; offsets[3] = 3; break;
+        case Format32::BGRA8888: offsets[0] = 1; offsets[1] = 2; offsets[2] = 3; offsets[3] = 0; break;
+        case Format32::RGBA8888: offsets[0] = 3; offsets[1] = 2; offsets[2] = 1; offsets[3] = 0; break;
+    }
+}
+
+const char* formatName(Format32 format) {
+    switch (format) {
+        case Format32::ARGB8888: return "ARGB8888";
+        case Format32::ABGR8888: return "ABGR8888";
+        case Format32::BGRA8888: return "BGRA8888";
+        case Format32::RGBA8888: return "RGBA8888";
+    }
+    return "?";
+}
+
+// For each destination byte of one pixel, the source byte it comes from
+static void permutation(Format32 from, Format32 to, int sourceByte[4]) {
+    int src[4], dst[4];
+    channelOffsets(from, src);
+    channelOffsets(to, dst);
+    for (int ch = 0; ch < 4; ++ch) sourceByte[dst[ch]] = src[ch];
+}
+
+// ---------------------------------------------------------------------------
+// Scalar references
+// ---------------------------------------------------------------------------
+
+void convert32Scalar(const uint32_t* src, uint32_t* dst, size_t count, Format32 from, Format32 to) {
+    int sourceByte[4];
+    permutation(from, to, sourceByte);
+    const uint8_t* in = (const uint8_t*)src;
+    uint8_t* out = (uint8_t*)dst;
+    for (size_t i = 0; i < count; ++i) {
+        uint8_t pixel[4] = {in[i * 4], in[i * 4 + 1], in[i * 4 + 2], in[i * 4 + 3]};
+        for (int b = 0; b < 4; ++b) out[i * 4 + b] = pixel[sourceByte[b]];
+    }
+}
+
+// 24-bit packed to ARGB8888 with opaque alpha. bgr = true for BMP/BGR24 byte order.
+void expand24Scalar(const uint8_t* src, uint32_t* dst, size_t count, bool bgr) {
+    for (size_t i = 0; i < count; ++i) {
+        uint8_t c0 = src[i * 3], c1 = src[i * 3 + 1], c2 = src[i * 3 + 2];
+        uint32_t r = bgr ? c2 : c0, b = bgr ? c0 : c2;
+        dst[i] = 0xFF000000 | (r << 16) | ((uint32_t)c1 << 8) | b;
+    }
+}
+
+// ARGB8888 to 24-bit packed (alpha dropped)
+void pack24Scalar(const uint32_t* src, uint8_t* dst, size_t count, bool bgr) {
+    for (size_t i = 0; i < count; ++i) {
+        uint8_t r = (src[i] >> 16) & 0xFF, g = (src[i] >> 8) & 0xFF, b = src[i] & 0xFF;
+        dst[i * 3] = bgr ? b : r;
+        dst[i * 3 + 1] = g;
+        dst[i * 3 + 2] = bgr ? r : b;
+    }
+}
+
+// RGB565 -> ARGB8888, expanding by bit replication so 0x1F maps to 0xFF
+void decode565Scalar(const uint16_t* src, uint32_t* dst, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        uint32_t r5 = (src[i] >> 11) & 0x1F, g6 = (src[i] >> 5) & 0x3F, b5 = src[i] & 0x1F;
+        uint32_t r = (r5 << 3) | (r5 >> 2), g = (g6 << 2) | (g6 >> 4), b = (b5 << 3) | (b5 >> 2);
+        dst[i] = 0xFF000000 | (r << 16) | (g << 8) | b;
+    }
+}
+
+// ARGB8888 -> RGB565, truncating like SDL_ConvertSurface
+void encode565Scalar(const uint32_t* src, uint16_t* dst, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        uint32_t p = src[i];
+        dst[i] = (uint16_t)(((p >> 8) & 0xF800) | ((p >> 5) & 0x07E0) | ((p >> 3) & 0x001F));
+    }
+}
+
+// ARGB1555 -> ARGB8888 (1-bit alpha becomes 0x00 or 0xFF)
+void decode1555Scalar(const uint16_t* src, uint32_t* dst, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        uint32_t a = (src[i] & 0x8000) ? 0xFF : 0x00;
+        uint32_t r5 = (src[i] >> 10) & 0x1F, g5 = (src[i] >> 5) & 0x1F, b5 = src[i] & 0x1F;
+        uint32_t r = (r5 << 3) | (r5 >> 2), g = (g5 << 3) | (g5 >> 2), b = (b5 << 3) | (b5 >> 2);
+        dst[i] = (a << 24) | (r << 16) | (g << 8) | b;
+    }
+}
+
+// ARGB8888 -> ARGB1555, alpha threshold at 128
+void encode1555Scalar(const uint32_t* src, uint16_t* dst, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        uint32_t p = src[i];
+        dst[i] = (uint16_t)(((p >> 16) & 0x8000) | ((p >> 9) & 0x7C00) |
+                            ((p >> 6) & 0x03E0) | ((p >> 3) & 0x001F));
+    }
+}
+
+// ---------------------------------------------------------------------------
+// SIMD kernels: AVX2 main loop, SSSE3 for what is left, scalar tail
+// ---------------------------------------------------------------------------
+
+void convert32(const uint32_t* src, uint32_t* dst, size_t count, Format32 from, Format32 to) {
+    int sourceByte[4];
+    permutation(from, to, sourceByte);
+    size_t i = 0;
+#ifdef __SSSE3__
+    alignas(16) int8_t mask[16];
+    for (int p = 0; p < 4; ++p) {
+        for (int b = 0; b < 4; ++b) mask[p * 4 + b] = (int8_t)(p * 4 + sourceByte[b]);
+    }
+    __m128i shuffle = _mm_load_si128((const __m128i*)mask);
+#ifdef __AVX2__
+    __m256i shuffle256 = _mm256_broadcastsi128_si256(shuffle);
+    for (; i + 16 <= count; i += 16) {
+        __m256i a = _mm256_loadu_si256((const __m256i*)(src + i));
+        __m256i b = _mm256_loadu_si256((const __m256i*)(src + i + 8));
+        _mm256_storeu_si256((__m256i*)(dst + i), _mm256_shuffle_epi8(a, shuffle256));
+        _mm256_storeu_si256((__m256i*)(dst + i + 8), _mm256_shuffle_epi8(b, shuffle256));
+    }
+#endif
+    for (; i + 4 <= count; i += 4) {
+        __m128i a = _mm_loadu_si128((const __m128i*)(src + i));
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_shuffle_epi8(a, shuffle));
+    }
+#endif
+    convert32Scalar(src + i, dst + i, count - i, from, to);
+}
+
+void expand24(const uint8_t* src, uint32_t* dst, size_t count, bool bgr) {
+    size_t i = 0;
+#ifdef __SSSE3__
+    // 4 pixels (12 bytes) per 128-bit lane; -1 zeroes the alpha byte, OR sets it
+    __m128i shuffle = bgr ? _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1)
+                          : _mm_setr_epi8(2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9, -1);
+    __m128i alpha = _mm_set1_epi32((int)0xFF000000);
+#ifdef __AVX2__
+    __m256i shuffle256 = _mm256_broadcastsi128_si256(shuffle);
+    __m256i alpha256 = _mm256_broadcastsi128_si256(alpha);
+    // Each 16-byte load reads 4 bytes past its 12: stop while a pixel of slack remains
+    for (; i + 10 <= count; i += 8) {
+        __m256i in = _mm256_inserti128_si256(
+            _mm256_castsi128_si256(_mm_loadu_si128((const __m128i*)(src + i * 3))),
+            _mm_loadu_si128((const __m128i*)(src + i * 3 + 12)), 1);
+        _mm256_storeu_si256((__m256i*)(dst + i),
+                            _mm256_or_si256(_mm256_shuffle_epi8(in, shuffle256), alpha256));
+    }
+#endif
+    for (; i + 6 <= count; i += 4) {
+        __m128i in = _mm_loadu_si128((const __m128i*)(src + i * 3));
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_or_si128(_mm_shuffle_epi8(in, shuffle), alpha));
+    }
+#endif
+    expand24Scalar(src + i * 3, dst + i, count - i, bgr);
+}
+
+void pack24(const uint32_t* src, uint8_t* dst, size_t count, bool bgr) {
+    size_t i = 0;
+#ifdef __SSSE3__
+    // Compact 4 pixels into the low 12 bytes; each 16-byte store spills 4 bytes
+    // that the next store overwrites, so keep a pixel of slack before the tail
+    __m128i shuffle = bgr ? _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1)
+                          : _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+#ifdef __AVX2__
+    __m256i shuffle256 = _mm256_broadcastsi128_si256(shuffle);
+    for (; i + 10 <= count; i += 8) {
+        __m256i packed = _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i*)(src + i)), shuffle256);
+        _mm_storeu_si128((__m128i*)(dst + i * 3), _mm256_castsi256_si128(packed));
+        _mm_storeu_si128((__m128i*)(dst + i * 3 + 12), _mm256_extracti128_si256(packed, 1));
+    }
+#endif
+    for (; i + 6 <= count; i += 4) {
+        __m128i packed = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(src + i)), shuffle);
+        _mm_storeu_si128((__m128i*)(dst + i * 3), packed);
+    }
+#endif
+    pack24Scalar(src + i, dst + i * 3, count - i, bgr);
+}
+
+// RGB565 decode and both ARGB1555 directions are plain shifts and masks that
+// the compiler vectorizes on its own at the widest width the target has; a
+// hand-written AVX2 version measured no faster (decode up to 2x slower), so
+// these use the scalar loop.
+void decode565(const uint16_t* src, uint32_t* dst, size_t count) {
+    decode565Scalar(src, dst, count);
+}
+
+void encode565(const uint32_t* src, uint16_t* dst, size_t count) {
+    size_t i = 0;
+#ifdef __AVX2__
+    const __m256i maskR = _mm256_set1_epi32(0xF800);
+    const __m256i maskG = _mm256_set1_epi32(0x07E0);
+    const __m256i maskB = _mm256_set1_epi32(0x001F);
+    for (; i + 16 <= count; i += 16) {
+        __m256i packed[2];
+        for (int half = 0; half < 2; ++half) {
+            __m256i p = _mm256_loadu_si256((const __m256i*)(src + i + half * 8));
+            packed[half] = _mm256_or_si256(
+                _mm256_or_si256(_mm256_and_si256(_mm256_srli_epi32(p, 8), maskR),
+                                _mm256_and_si256(_mm256_srli_epi32(p, 5), maskG)),
+                _mm256_and_si256(_mm256_srli_epi32(p, 3), maskB));
+        }
+        // packus works per 128-bit lane; permute restores pixel order
+        __m256i words = _mm256_permute4x64_epi64(_mm256_packus_epi32(packed[0], packed[1]),
+                                                 _MM_SHUFFLE(3, 1, 2, 0));
+        _mm256_storeu_si256((__m256i*)(dst + i), words);
+    }
+#endif
+    encode565Scalar(src + i, dst + i, count - i);
+}
+
+void decode1555(const uint16_t* src, uint32_t* dst, size_t count) {
+    decode1555Scalar(src, dst, count);
+}
+
+void encode1555(const uint32_t* src, uint16_t* dst, size_t count) {
+    encode1555Scalar(src, dst, count);
+}
+
+// ---------------------------------------------------------------------------
+// Exhaustive correctness tests
+// ---------------------------------------------------------------------------
+
+static bool reportTest(const char* name, bool ok) {
+    cout << "  " << left << setw(44) << name << (ok ? "✓ PASSED" : "✗ FAILED") << endl;
+    return ok;
+}
+
+// Every 24-bit color, with alpha varying independently of the color channels
+static vector<uint32_t> allColors() {
+    vector<uint32_t> colors(1u << 24);
+    for (uint32_t i = 0; i < colors.size(); ++i) {
+        colors[i] = ((i * 167u) & 0xFF) << 24 | i;
+    }
+    return colors;
+}
+
+bool runCorrectnessTests() {
+    bool ok = true;
+    vector<uint32_t> colors = allColors();
+    const size_t n = colors.size();
+    vector<uint32_t> expected32(n), actual32(n);
+
+    cout << "Exhaustive tests (all 2^24 colors, all 2^16 packed values):" << endl;
+
+    // All 12 channel permutations, plus in-place use
+    const Format32 formats[] = {Format32::ARGB8888, Format32::ABGR8888, Format32::BGRA8888, Format32::RGBA8888};
+    bool permOk = true, roundTripOk = true;
+    for (Format32 from : formats) {
+        for (Format32 to : formats) {
+            if (from == to) continue;
+            convert32Scalar(colors.data(), expected32.data(), n, from, to);
+            convert32(colors.data(), actual32.data(), n, from, to);
+            permOk = permOk && expected32 == actual32;
+            convert32(actual32.data(), actual32.data(), n, to, from);
+            roundTripOk = roundTripOk && actual32 == colors;
+        }
+    }
+    ok &= reportTest("32-bit permutations (12 pairs) vs scalar", permOk);
+    ok &= reportTest("32-bit permutation round trips (in place)", roundTripOk);
+
+    // 24 <-> 32
+    vector<uint8_t> expected24(n * 3), actual24(n * 3);
+    bool expandOk = true, packOk = true;
+    for (bool bgr : {true, false}) {
+        pack24Scalar(colors.data(), expected24.data(), n, bgr);
+        pack24(colors.data(), actual24.data(), n, bgr);
+        packOk = packOk && expected24 == actual24;
+        expand24Scalar(expected24.data(), expected32.data(), n, bgr);
+        expand24(expected24.data(), actual32.data(), n, bgr);
+        expandOk = expandOk && expected32 == actual32;
+        for (size_t i = 0; i < n && expandOk; ++i) {
+            expandOk = actual32[i] == (colors[i] | 0xFF000000);
+        }
+    }
+    ok &= reportTest("24-bit pack (BGR24 and RGB24) vs scalar", packOk);
+    ok &= reportTest("24-bit expand vs scalar + round trip", expandOk);
+
+    // 16-bit: every packed value decodes like the reference and re-encodes to itself
+    vector<uint16_t> all16(65536), encoded(65536);
+    vector<uint32_t> decodedRef(65536), decoded(65536);
+    for (uint32_t v = 0; v < 65536; ++v) all16[v] = (uint16_t)v;
+
+    decode565Scalar(all16.data(), decodedRef.data(), 65536);
+    decode565(all16.data(), decoded.data(), 65536);
+    encode565(decoded.data(), encoded.data(), 65536);
+    ok &= reportTest("RGB565 decode + re-encode (all 65536)", decoded == decodedRef && encoded == all16);
+
+    decode1555Scalar(all16.data(), decodedRef.data(), 65536);
+    decode1555(all16.data(), decoded.data(), 65536);
+    encode1555(decoded.data(), encoded.data(), 65536);
+    ok &= reportTest("ARGB1555 decode + re-encode (all 65536)", decoded == decodedRef && encoded == all16);
+
+    // Encoders against every 24-bit color
+    vector<uint16_t> expected16(n), actual16(n);
+    encode565Scalar(colors.data(), expected16.data(), n);
+    encode565(colors.data(), actual16.data(), n);
+    ok &= reportTest("RGB565 encode of all colors vs scalar", expected16 == actual16);
+    encode1555Scalar(colors.data(), expected16.data(), n);
+    encode1555(colors.data(), actual16.data(), n);
+    ok &= reportTest("ARGB1555 encode of all colors vs scalar", expected16 == actual16);
+
+    // Short and odd lengths exercise every head/tail combination without
+    // writing past the end of the destination
+    bool tailsOk = true;
+    for (size_t count = 0; count <= 40; ++count) {
+        vector<uint8_t> out24(count * 3 + 16, 0xCD);
+        vector<uint32_t> out32(count + 8, 0xCDCDCDCD);
+        vector<uint16_t> out16(count + 8, 0xCDCD);
+        pack24(colors.data() + 12345, out24.data(), count, true);
+        tailsOk = tailsOk && all_of(out24.begin() + count * 3, out24.end(), [](uint8_t v) { return v == 0xCD; });
+        expand24(out24.data(), out32.data(), count, true);
+        convert32(colors.data(), out32.data(), count, Format32::ARGB8888, Format32::RGBA8888);
+        encode565(colors.data(), out16.data(), count);
+        encode1555(colors.data(), out16.data(), count);
+        decode565(all16.data(), out32.data(), count);
+        decode1555(all16.data(), out32.data(), count);
+        tailsOk = tailsOk && all_of(out32.begin() + count, out32.end(), [](uint32_t v) { return v == 0xCDCDCDCD; });
+        tailsOk = tailsOk && all_of(out16.begin() + count, out16.end(), [](uint16_t v) { return v == 0xCDCD; });
+    }
+    ok &= reportTest("Lengths 0..40 stay inside destination", tailsOk);
+    return ok;
+}
+
+// ---------------------------------------------------------------------------
+// Benchmark
+// ---------------------------------------------------------------------------
+
+template <typename Fn>
+double mpixPerSec(size_t pixels, Fn fn) {
+    const int iterations = 20;
+    fn(); // warm up
+    auto start = high_resolution_clock::now();
+    for (int i = 0; i < iterations; ++i) fn();
+    double sec = duration<double>(high_resolution_clock::now() - start).count();
+    return pixels * iterations / sec / 1e6;
+}
+
+void benchmark() {
+    const size_t n = 1920 * 1080;
+    vector<uint32_t> src32(n), dst32(n);
+    vector<uint8_t> buf24(n * 3);
+    vector<uint16_t> buf16(n);
+    for (size_t i = 0; i < n; ++i) src32[i] = (uint32_t)(i * 2654435761u);
+    pack24Scalar(src32.data(), buf24.data(), n, true);
+    encode565Scalar(src32.data(), buf16.data(), n);
+
+    cout << "\n=== 1920x1080 conversion throughput (Mpixels/s) ===" << endl;
+    cout << left << setw(30) << "Conversion" << right << setw(12) << "scalar" << setw(12) << "SIMD"
+         << setw(10) << "speedup" << endl;
+    auto row = [&](const char* name, double scalar, double simd) {
+        cout << left << setw(30) << name << right << fixed << setprecision(0) << setw(12) << scalar
+             << setw(12) << simd << setw(9) << setprecision(2) << simd / scalar << "x" << endl;
+    };
+
+    row("ARGB8888 -> ABGR8888",
+        mpixPerSec(n, [&] { convert32Scalar(src32.data(), dst32.data(), n, Format32::ARGB8888, Format32::ABGR8888); }),
+        mpixPerSec(n, [&] { convert32(src32.data(), dst32.data(), n, Format32::ARGB8888, Format32::ABGR8888); }));
+    row("BGRA8888 -> ARGB8888",
+        mpixPerSec(n, [&] { convert32Scalar(src32.data(), dst32.data(), n, Format32::BGRA8888, Format32::ARGB8888); }),
+        mpixPerSec(n, [&] { convert32(src32.data(), dst32.data(), n, Format32::BGRA8888, Format32::ARGB8888); }));
+    row("BGR24 (BMP) -> ARGB8888",
+        mpixPerSec(n, [&] { expand24Scalar(buf24.data(), dst32.data(), n, true); }),
+        mpixPerSec(n, [&] { expand24(buf24.data(), dst32.data(), n, true); }));
+    row("ARGB8888 -> RGB24",
+        mpixPerSec(n, [&] { pack24Scalar(src32.data(), buf24.data(), n, false); }),
+        mpixPerSec(n, [&] { pack24(src32.data(), buf24.data(), n, false); }));
+    row("RGB565 -> ARGB8888 *",
+        mpixPerSec(n, [&] { decode565Scalar(buf16.data(), dst32.data(), n); }),
+        mpixPerSec(n, [&] { decode565(buf16.data(), dst32.data(), n); }));
+    row("ARGB8888 -> RGB565",
+        mpixPerSec(n, [&] { encode565Scalar(src32.data(), buf16.data(), n); }),
+        mpixPerSec(n, [&] { encode565(src32.data(), buf16.data(), n); }));
+    row("ARGB1555 -> ARGB8888 *",
+        mpixPerSec(n, [&] { decode1555Scalar(buf16.data(), dst32.data(), n); }),
+        mpixPerSec(n, [&] { decode1555(buf16.data(), dst32.data(), n); }));
+    row("ARGB8888 -> ARGB1555 *",
+        mpixPerSec(n, [&] { encode1555Scalar(src32.data(), buf16.data(), n); }),
+        mpixPerSec(n, [&] { encode1555(src32.data(), buf16.data(), n); }));
+    cout << "(* no hand-written kernel: the compiler-vectorized scalar loop is as fast, so both columns run it)" << endl;
+}
+
+int main(int argc, char** args) {
+    cout << "=== Chapter 3: Bulk Pixel Format Conversion ===" << endl;
+    cout << "SIMD path: ";
+#if defined(__AVX2__)
+    cout << "AVX2 + SSSE3" << endl;
+#elif defined(__SSSE3__)
+    cout << "SSSE3" << endl;
+#else
+    cout << "scalar (compile with -march=native for SSSE3/AVX2)" << endl;
+#endif
+
+    bool ok = runCorrectnessTests();
+    benchmark();
+    return ok ? 0 : 1;
+}
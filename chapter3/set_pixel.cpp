@@ -2,6 +2,8 @@
 
 #include <unistd.h>
 #include <iostream>
+#include <vector>
+#include <span>
 
 //SDL3 library
 
@@ -36,6 +38,49 @@ void setPixelSDL(SDL_Surface* surface, int x, int y, uint8_t a, uint8_t r, uint8
     SDL_UnlockSurface(surface);
 }
 
+struct Point {
+    int32_t x;
+    int32_t y;
+};
+
+// Batched version: one lock for the whole set of points instead of one per pixel.
+// colors[i] is the ARGB color of points[i]; later points win where they overlap.
+// Nothing is drawn if there are fewer colors than points.
+// See plot_points.cpp for the AVX2/AVX-512 clip + scatter version and benchmark.
+void plotPoints(SDL_Surface* surface, span<const Point> points, span<const uint32_t> colors) {
+    if (colors.size() < points.size()) {
+        cout << "plotPoints: " << colors.size() << " colors for " << points.size() << " points" << endl;
+        return;
+    }
+    if (points.empty() || !SDL_LockSurface(surface)) return;
+
+    uint32_t* pixels = (uint32_t*)surface->pixels;
+    int pitch = surface->pitch / 4;
+    for (size_t i = 0; i < points.size(); ++i) {
+        // Unsigned compare rejects negative coordinates as well
+        if ((unsigned)points[i].x < (unsigned)surface->w && (unsigned)points[i].y < (unsigned)surface->h) {
+            pixels[points[i].y * pitch + points[i].x] = colors[i];
+        }
+    }
+
+    SDL_UnlockSurface(surface);
+}
+
+// Same, with one color for every point
+void plotPoints(SDL_Surface* surface, span<const Point> points, uint32_t color) {
+    if (points.empty() || !SDL_LockSurface(surface)) return;
+
+    uint32_t* pixels = (uint32_t*)surface->pixels;
+    int pitch = surface->pitch / 4;
+    for (const Point& p : points) {
+        if ((unsigned)p.x < (unsigned)surface->w && (unsigned)p.y < (unsigned)surface->h) {
+            pixels[p.y * pitch + p.x] = color;
+        }
+    }
+
+    SDL_UnlockSurface(surface);
+}
+
 void demo_set_pixel(SDL_Surface* surface) {
     cout << "Drawing test pattern using setPixelARGB32..." << endl;
     
@@ -51,24 +96,31 @@ void demo_set_pixel(SDL_Surface* surface) {
     SDL_UnlockSurface(surface);
     
     // Draw colorful pattern
+    vector<Point> points;
+    vector<uint32_t> colors;
     for(int y = 50; y < surface->h - 50; y += 10) {
         for(int x = 50; x < surface->w - 50; x += 10) {
             uint8_t r = (x * 255) / surface->w;
             uint8_t g = (y * 255) / surface->h;
             uint8_t b = 128;
-            setPixelSDL(surface, x, y, 255, r, g, b);
+            points.push_back({x, y});
+            colors.push_back((255u << 24) | (r << 16) | (g << 8) | b);
         }
     }
     
     // Draw a border
     for(int x = 0; x < surface->w; ++x) {
-        setPixelSDL(surface, x, 0, 255, 255, 255, 255);      // Top border
-        setPixelSDL(surface, x, surface->h-1, 255, 255, 255, 255); // Bottom border
+        points.push_back({x, 0});                // Top border
+        points.push_back({x, surface->h - 1});   // Bottom border
     }
     for(int y = 0; y < surface->h; ++y) {
-        setPixelSDL(surface, 0, y, 255, 255, 255, 255);      // Left border
-        setPixelSDL(surface, surface->w-1, y, 255, 255, 255, 255); // Right border
+        points.push_back({0, y});                // Left border
+        points.push_back({surface->w - 1, y});   // Right border
     }
+    colors.resize(points.size(), 0xFFFFFFFF);
+    
+    // One lock/unlock for every point instead of one per setPixelSDL call
+    plotPoints(surface, points, colors);
 }
 
 int main(int argc, char** args) {
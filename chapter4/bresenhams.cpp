@@ -3,6 +3,7 @@
 #include <unistd.h>
 #include <iostream>
 #include <cmath>
+#include <vector>
 
 //SDL3 library
 
@@ -56,6 +57,27 @@ void drawLineBresenhamsSDL(int x0, int y0, int x1, int y1, uint32_t color, SDL_S
     SDL_UnlockSurface(surface);
 }
 
+struct Line {
+    int x0, y0, x1, y1;
+    uint32_t color;
+};
+
+// Batch wrapper: one lock for a whole set of lines instead of one per line.
+// line_engine.cpp adds up-front clipping and axis/diagonal fast paths.
+void drawLinesBresenhamSDL(const Line* lines, size_t count, SDL_Surface* surface) {
+    SDL_LockSurface(surface);
+    uint8_t* framebuffer = (uint8_t*)surface->pixels;
+    int stride = surface->pitch;
+    int bytesPerPixel = SDL_BYTESPERPIXEL(surface->format);
+    
+    for (size_t i = 0; i < count; ++i) {
+        const Line& line = lines[i];
+        drawLineBresenham(line.x0, line.y0, line.x1, line.y1, line.color,
+                          framebuffer, stride, bytesPerPixel, surface->w, surface->h);
+    }
+    SDL_UnlockSurface(surface);
+}
+
 void demo_bresenham_lines(SDL_Surface* surface) {
     // Clear to black
     SDL_LockSurface(surface);
@@ -81,14 +103,15 @@ void demo_bresenham_lines(SDL_Surface* surface) {
         drawLineBresenhamsSDL(centerX, centerY, x1, y1, 0xFFFFFFFF, surface); // White
     }
     
-    // Grid lines (vertical)
+    // Grid lines, submitted as one batch
+    vector<Line> grid;
     for(int x = 50; x < surface->w; x += 50) {
-        drawLineBresenhamsSDL(x, 0, x, surface->h - 1, 0xFF404040, surface); // Dark gray
+        grid.push_back({x, 0, x, surface->h - 1, 0xFF404040}); // Dark gray vertical
     }
-    // Grid lines (horizontal)
     for(int y = 50; y < surface->h; y += 50) {
-        drawLineBresenhamsSDL(0, y, surface->w - 1, y, 0xFF404040, surface); // Dark gray
+        grid.push_back({0, y, surface->w - 1, y, 0xFF404040}); // Dark gray horizontal
     }
+    drawLinesBresenhamSDL(grid.data(), grid.size(), surface);
     
     // Diagonal lines in different colors
     drawLineBresenhamsSDL(0, 0, surface->w - 1, surface->h - 1, 0xFFFF0000, surface); // Red
@@ -10,12 +10,12 @@
 
 using namespace std;
 
+// Caller holds the surface lock (see drawMidpointCircle)
 void plotCirclePoints(int cx, int cy, int x, int y, uint32_t color, SDL_Surface* framebuffer, int stride){
-  SDL_LockSurface(framebuffer);
   uint32_t* pixelPtr = (uint32_t*)framebuffer->pixels;
 
   auto setPixel = [&](int px, int py){
-  if (px < 0 || py < 0){
+  if (px < 0 || py < 0 || px >= framebuffer->w || py >= framebuffer->h){
     return;
   }
   int offset = py * stride + px;
@@ -30,14 +30,15 @@ void plotCirclePoints(int cx, int cy, int x, int y, uint32_t color, SDL_Surface*
   setPixel(cx - y, cy + x);
   setPixel(cx + y, cy - x);
   setPixel(cx - y, cy - x);
-
-  SDL_UnlockSurface(framebuffer);
 }
 
 void drawMidpointCircle(int cx, int cy, int radius, uint32_t color, SDL_Surface* framebuffer, int stride){
   int x = 0;
   int y = radius;
   int p = 1 - radius;
+
+  // One lock for the whole circle rather than one per group of eight points
+  SDL_LockSurface(framebuffer);
   plotCirclePoints(cx, cy, x, y, color, framebuffer, stride);
 
   while(x < y){
@@ -51,6 +52,7 @@ void drawMidpointCircle(int cx, int cy, int radius, uint32_t color, SDL_Surface*
     }
     plotCirclePoints(cx, cy, x, y, color, framebuffer, stride);
   }
+  SDL_UnlockSurface(framebuffer);
 }
 
 int main(int argc, char** args) {
@@ -79,7 +81,7 @@ int main(int argc, char** args) {
   }
 
   //Draw a white circle at coordinates (640, 360) with radios 100
-  drawMidpointCircle(640, 360, 100, 0xFFFFFFFF, surface, 1280);
+  drawMidpointCircle(640, 360, 100, 0xFFFFFFFF, surface, surface->pitch / 4);
   SDL_UpdateWindowSurface( window );
     
   while(!quit){
@@ -11,23 +11,31 @@
 
 using namespace std;
 
+// Span half-width for row y is the largest x with x*x + y*y <= r*r. It only
+// shrinks as |y| grows, so it is walked down with integer compares instead of
+// calling sqrt per scanline (span_circle_ellipse.cpp has the full rasterizer).
 void fillCircle(int cx, int cy, int radius, uint32_t color, SDL_Surface* framebuffer, int stride){
-  for(int y = -radius; y <= radius; y++){
-    int scanlineY = cy + y;
-    if(scanlineY < 0) continue;
-    if(scanlineY >= framebuffer->h) break;
+  uint32_t* pixelPtr = (uint32_t*)framebuffer->pixels;
+  int xSpan = radius;
+
+  for(int y = 0; y <= radius; y++){
+    while(xSpan * xSpan + y * y > radius * radius){
+      xSpan--;
+    }
 
-    int xSpan = static_cast<int>(sqrt(radius * radius - y * y));
     int xStart = cx - xSpan;
     int xEnd = cx + xSpan;
 
     if(xStart < 0) xStart = 0;
     if(xEnd >= framebuffer->w) xEnd = framebuffer->w -1;
 
-    for(int x = xStart; x <= xEnd; x++){
-      int offset = scanlineY * stride + x;
-      uint32_t* pixelPtr = (uint32_t*)framebuffer->pixels;
-      pixelPtr[offset] = color;
+    // Upper and lower scanlines share the same span
+    for(int scanlineY : {cy - y, cy + y}){
+      if(scanlineY < 0 || scanlineY >= framebuffer->h) continue;
+      for(int x = xStart; x <= xEnd; x++){
+        pixelPtr[scanlineY * stride + x] = color;
+      }
+      if(y == 0) break;
     }
   }
 }
@@ -58,7 +66,7 @@ int main(int argc, char** args) {
   }
 
   //Fill a circle with white color
-  fillCircle(640, 360, 100, 0xFFFFFFFF, surface, 1280);
+  fillCircle(640, 360, 100, 0xFFFFFFFF, surface, surface->pitch / 4);
   SDL_UpdateWindowSurface( window );
     
   while(!quit){
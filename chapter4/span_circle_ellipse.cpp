@@ -0,0 +1,397 @@
+//Chapter 4: Drawing Primitives - Span-Based Midpoint Circle and Ellipse Rasterizer
+//Standard C++ libraries
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include <array>
+#include <random>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+
+//SIMD intrinsics
+#include <immintrin.h>  // AVX2 span stores (falls back to scalar when unavailable)
+
+using namespace std;
+using namespace std::chrono;
+
+// ARGB8888 target, pitch in pixels
+struct SpanSurface {
+    uint32_t* pixels;
+    int width;
+    int height;
+    int pitch;
+};
+
+// Clipped horizontal span [x0, x1] on row y: the only place that touches pixels
+static inline void fillSpan(const SpanSurface& surface, int y, int x0, int x1, uint32_t color) {
+    if (y < 0 || y >= surface.height) return;
+    x0 = max(x0, 0);
+    x1 = min(x1, surface.width - 1);
+    if (x0 > x1) return;
+
+    uint32_t* dst = surface.pixels + (size_t)y * surface.pitch + x0;
+    int count = x1 - x0 + 1;
+    int i = 0;
+#ifdef __AVX2__
+    __m256i colorVec = _mm256_set1_epi32((int)color);
+    for (; i + 8 <= count; i += 8) {
+        _mm256_storeu_si256((__m256i*)(dst + i), colorVec);
+    }
+#endif
+    for (; i < count; ++i) dst[i] = color;
+}
+
+// Filled circle: every pixel with x^2 + y^2 <= r^2, one span per row.
+// The half-width only ever shrinks as |y| grows, so it is walked down with
+// integer compares: O(r) work in total, no sqrt, no per-pixel test.
+void fillCircleSpans(const SpanSurface& surface, int cx, int cy, int radius, uint32_t color) {
+    if (radius < 0) return;
+    if (cx + radius < 0 || cx - radius >= surface.width ||
+        cy + radius < 0 || cy - radius >= surface.height) return;
+
+    const int64_t r2 = (int64_t)radius * radius;
+    int64_t x = radius;
+    for (int64_t y = 0; y <= radius; ++y) {
+        while (x * x + y * y > r2) --x;
+        fillSpan(surface, (int)(cy - y), (int)(cx - x), (int)(cx + x), color);
+        if (y != 0) fillSpan(surface, (int)(cy + y), (int)(cx - x), (int)(cx + x), color);
+    }
+}
+
+// Filled axis-aligned ellipse: b^2 x^2 + a^2 y^2 <= a^2 b^2
+void fillEllipseSpans(const SpanSurface& surface, int cx, int cy, int a, int b, uint32_t color) {
+    if (a < 0 || b < 0) return;
+    if (cx + a < 0 || cx - a >= surface.width || cy + b < 0 || cy - b >= surface.height) return;
+
+    const int64_t a2 = (int64_t)a * a, b2 = (int64_t)b * b, limit = a2 * b2;
+    int64_t x = a;
+    for (int64_t y = 0; y <= b; ++y) {
+        while (x >= 0 && b2 * x * x + a2 * y * y > limit) --x;
+        fillSpan(surface, (int)(cy - y), (int)(cx - x), (int)(cx + x), color);
+        if (y != 0) fillSpan(surface, (int)(cy + y), (int)(cx - x), (int)(cx + x), color);
+    }
+}
+
+// Circle outline with the midpoint decision variable from draw_circle.cpp.
+// In the octants where x advances every step, consecutive points on the same
+// row are merged into one span; the steep octants emit one-pixel spans.
+void drawCircleSpans(const SpanSurface& surface, int cx, int cy, int radius, uint32_t color) {
+    if (radius < 0) return;
+    if (cx + radius < 0 || cx - radius >= surface.width ||
+        cy + radius < 0 || cy - radius >= surface.height) return;
+
+    int x = 0, y = radius, p = 1 - radius;
+    int runStart = 0;
+
+    auto flushRun = [&](int runEnd, int row) {
+        fillSpan(surface, cy + row, cx + runStart, cx + runEnd, color);
+        fillSpan(surface, cy + row, cx - runEnd, cx - runStart, color);
+        fillSpan(surface, cy - row, cx + runStart, cx + runEnd, color);
+        fillSpan(surface, cy - row, cx - runEnd, cx - runStart, color);
+    };
+    auto steepPoints = [&](int px, int py) {
+        fillSpan(surface, cy + px, cx + py, cx + py, color);
+        fillSpan(surface, cy + px, cx - py, cx - py, color);
+        fillSpan(surface, cy - px, cx + py, cx + py, color);
+        fillSpan(surface, cy - px, cx - py, cx - py, color);
+    };
+
+    steepPoints(x, y);
+    while (x < y) {
+        x++;
+        if (p < 0) {
+            p += 2 * x + 1;
+        } else {
+            // Row changes: the run at the old row ended at the previous x
+            flushRun(x - 1, y);
+            runStart = x;
+            y--;
+            p += 2 * (x - y) + 1;
+        }
+        steepPoints(x, y);
+    }
+    flushRun(x, y);
+}
+
+// Ellipse outline, standard two-region midpoint algorithm in integers.
+// Region 1 (|slope| < 1) steps x and merges rows into spans; region 2 steps y.
+void drawEllipseSpans(const SpanSurface& surface, int cx, int cy, int a, int b, uint32_t color) {
+    if (a < 0 || b < 0) return;
+    if (cx + a < 0 || cx - a >= surface.width || cy + b < 0 || cy - b >= surface.height) return;
+
+    // Degenerate ellipses are segments: region 1 would stop after one pixel
+    // when b == 0, so both cases are drawn directly
+    if (b == 0) {
+        fillSpan(surface, cy, cx - a, cx + a, color);
+        return;
+    }
+    if (a == 0) {
+        for (int y = cy - b; y <= cy + b; ++y) fillSpan(surface, y, cx, cx, color);
+        return;
+    }
+
+    const int64_t a2 = (int64_t)a * a, b2 = (int64_t)b * b;
+    int64_t x = 0, y = b;
+    int64_t runStart = 0;
+
+    auto emitRow = [&](int64_t x0, int64_t x1, int64_t row) {
+        fillSpan(surface, (int)(cy + row), (int)(cx + x0), (int)(cx + x1), color);
+        fillSpan(surface, (int)(cy + row), (int)(cx - x1), (int)(cx - x0), color);
+        fillSpan(surface, (int)(cy - row), (int)(cx + x0), (int)(cx + x1), color);
+        fillSpan(surface, (int)(cy - row), (int)(cx - x1), (int)(cx - x0), color);
+    };
+
+    // Region 1: decision scaled by 4 to stay in integers
+    int64_t d1 = 4 * b2 - 4 * a2 * b + a2;
+    while (b2 * x < a2 * y) {
+        if (d1 < 0) {
+            d1 += 4 * b2 * (2 * x + 3);
+            x++;
+        } else {
+            emitRow(runStart, x, y);
+            d1 += 4 * b2 * (2 * x + 3) + 4 * a2 * (-2 * y + 2);
+            x++;
+            y--;
+            runStart = x;
+        }
+    }
+    emitRow(runStart, x, y);
+
+    // Region 2
+    int64_t d2 = b2 * (2 * x + 1) * (2 * x + 1) + 4 * a2 * (y - 1) * (y - 1) - 4 * a2 * b2;
+    while (y > 0) {
+        if (d2 > 0) {
+            d2 += 4 * a2 * (-2 * y + 3);
+            y--;
+        } else {
+            d2 += 4 * b2 * (2 * x + 2) + 4 * a2 * (-2 * y + 3);
+            x++;
+            y--;
+        }
+        emitRow(x, x, y);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// References
+// ---------------------------------------------------------------------------
+
+static inline void putPixelChecked(const SpanSurface& s, int x, int y, uint32_t color) {
+    if (x >= 0 && x < s.width && y >= 0 && y < s.height) s.pixels[(size_t)y * s.pitch + x] = color;
+}
+
+// chapter7/chapter12 drawCircle: bounding box with a per-pixel test
+void fillCircleBoundingBox(const SpanSurface& s, int cx, int cy, int radius, uint32_t color) {
+    for (int y = -radius; y <= radius; ++y) {
+        for (int x = -radius; x <= radius; ++x) {
+            if (x * x + y * y <= radius * radius) putPixelChecked(s, cx + x, cy + y, color);
+        }
+    }
+}
+
+// fill_circle.cpp: sqrt per scanline
+void fillCircleSqrt(const SpanSurface& s, int cx, int cy, int radius, uint32_t color) {
+    for (int y = -radius; y <= radius; y++) {
+        int scanlineY = cy + y;
+        if (scanlineY < 0) continue;
+        if (scanlineY >= s.height) break;
+        int xSpan = static_cast<int>(sqrt(radius * radius - y * y));
+        int xStart = max(cx - xSpan, 0);
+        int xEnd = min(cx + xSpan, s.width - 1);
+        for (int x = xStart; x <= xEnd; x++) s.pixels[(size_t)scanlineY * s.pitch + x] = color;
+    }
+}
+
+void fillEllipseBoundingBox(const SpanSurface& s, int cx, int cy, int a, int b, uint32_t color) {
+    const int64_t a2 = (int64_t)a * a, b2 = (int64_t)b * b;
+    for (int y = -b; y <= b; ++y) {
+        for (int x = -a; x <= a; ++x) {
+            if (b2 * x * x + a2 * y * y <= a2 * b2) putPixelChecked(s, cx + x, cy + y, color);
+        }
+    }
+}
+
+// draw_circle.cpp midpoint outline, with the right/bottom bounds check it was missing
+void drawCircleMidpointReference(const SpanSurface& s, int cx, int cy, int radius, uint32_t color) {
+    auto plot8 = [&](int x, int y) {
+        putPixelChecked(s, cx + x, cy + y, color); putPixelChecked(s, cx - x, cy + y, color);
+        putPixelChecked(s, cx + x, cy - y, color); putPixelChecked(s, cx - x, cy - y, color);
+        putPixelChecked(s, cx + y, cy + x, color); putPixelChecked(s, cx - y, cy + x, color);
+        putPixelChecked(s, cx + y, cy - x, color); putPixelChecked(s, cx - y, cy - x, color);
+    };
+    int x = 0, y = radius, p = 1 - radius;
+    plot8(x, y);
+    while (x < y) {
+        x++;
+        if (p < 0) {
+            p += 2 * x + 1;
+        } else {
+            y--;
+            p += 2 * (x - y) + 1;
+        }
+        plot8(x, y);
+    }
+}
+
+// Per-pixel outline test, independent of the midpoint stepping: the pixel at
+// offset (x, y) may be lit only if the ideal curve b^2 X^2 + a^2 Y^2 = a^2 b^2
+// passes within one pixel of it, i.e. through the square [x-1, x+1] x [y-1, y+1].
+// Half a pixel is too tight for the midpoint ellipse: over a, b <= 190 some lit
+// pixels sit more than 0.75 px from the curve, none more than 1.
+// The axis points catch a thin ellipse's tip poking into a square whose four
+// corners are all outside.
+static bool curveNearPixel(int64_t a, int64_t b, int64_t x, int64_t y) {
+    if (a == 0 || b == 0) return (b == 0 && y == 0 && llabs(x) <= a) || (a == 0 && x == 0 && llabs(y) <= b);
+    const int64_t a2 = a * a, b2 = b * b;
+    auto f = [&](int64_t X, int64_t Y) { return b2 * X * X + a2 * Y * Y - a2 * b2; };
+    int64_t lo = INT64_MAX, hi = INT64_MIN;
+    for (int64_t X : {x - 1, x + 1}) {
+        for (int64_t Y : {y - 1, y + 1}) {
+            lo = min(lo, f(X, Y));
+            hi = max(hi, f(X, Y));
+        }
+    }
+    if (llabs(x) <= 1) lo = min({lo, f(0, y - 1), f(0, y + 1)});
+    if (llabs(y) <= 1) lo = min({lo, f(x - 1, 0), f(x + 1, 0)});
+    return lo <= 0 && hi >= 0;
+}
+
+// ---------------------------------------------------------------------------
+// Verification and benchmark
+// ---------------------------------------------------------------------------
+
+struct Canvas {
+    vector<uint32_t> pixels;
+    SpanSurface surface;
+    Canvas(int w, int h, int pad) : pixels((size_t)(w + pad) * h, 0) {
+        surface = {pixels.data(), w, h, w + pad};
+    }
+    void clear() { fill(pixels.begin(), pixels.end(), 0); }
+};
+
+// Outline drawn unclipped around the middle of `whole`: every lit pixel must
+// pass curveNearPixel, and the curve must be closed, with every column in
+// [-a, a] lit above and below the axis and every row in [-b, b] left and right.
+static bool checkEllipseOutline(const Canvas& whole, int a, int b) {
+    const SpanSurface& s = whole.surface;
+    const int cx = s.width / 2, cy = s.height / 2;
+    vector<uint8_t> colAbove(2 * a + 1), colBelow(2 * a + 1), rowLeft(2 * b + 1), rowRight(2 * b + 1);
+    for (int py = 0; py < s.height; ++py) {
+        for (int px = 0; px < s.width; ++px) {
+            if (!whole.pixels[(size_t)py * s.pitch + px]) continue;
+            int x = px - cx, y = py - cy;
+            if (!curveNearPixel(a, b, x, y)) return false;
+            if (abs(x) <= a) {
+                if (y <= 0) colAbove[x + a] = 1;
+                if (y >= 0) colBelow[x + a] = 1;
+            }
+            if (abs(y) <= b) {
+                if (x <= 0) rowLeft[y + b] = 1;
+                if (x >= 0) rowRight[y + b] = 1;
+            }
+        }
+    }
+    auto all = [](const vector<uint8_t>& v) { return all_of(v.begin(), v.end(), [](uint8_t f) { return f != 0; }); };
+    return all(colAbove) && all(colBelow) && all(rowLeft) && all(rowRight);
+}
+
+bool verifyShapes() {
+    Canvas ref(97, 61, 3), out(97, 61, 3);
+    Canvas whole(131, 101, 0);  // holds every tested ellipse unclipped
+    bool ok = true;
+    // Every radius up to 60 at centers inside, on and outside every edge
+    const int centers[][2] = {{48, 30}, {0, 0}, {96, 60}, {-20, 30}, {120, 30}, {48, -40}, {48, 90}, {5, 57}};
+    for (auto& c : centers) {
+        for (int r = 0; r <= 60 && ok; ++r) {
+            ref.clear(); out.clear();
+            fillCircleBoundingBox(ref.surface, c[0], c[1], r, 0xFFFFFFFF);
+            fillCircleSpans(out.surface, c[0], c[1], r, 0xFFFFFFFF);
+            ok = ok && ref.pixels == out.pixels;
+
+            ref.clear(); out.clear();
+            drawCircleMidpointReference(ref.surface, c[0], c[1], r, 0xFFFFFFFF);
+            drawCircleSpans(out.surface, c[0], c[1], r, 0xFFFFFFFF);
+            ok = ok && ref.pixels == out.pixels;
+
+            for (int b = 0; b <= 45 && ok; b += 3) {
+                ref.clear(); out.clear();
+                fillEllipseBoundingBox(ref.surface, c[0], c[1], r, b, 0xFFFFFFFF);
+                fillEllipseSpans(out.surface, c[0], c[1], r, b, 0xFFFFFFFF);
+                ok = ok && ref.pixels == out.pixels;
+
+                // Per-pixel outline check unclipped, then the clipped draw must
+                // equal the unclipped one shifted onto this canvas
+                whole.clear(); out.clear();
+                drawEllipseSpans(whole.surface, whole.surface.width / 2, whole.surface.height / 2, r, b, 0xFFFFFFFF);
+                ok = ok && checkEllipseOutline(whole, r, b);
+                drawEllipseSpans(out.surface, c[0], c[1], r, b, 0xFFFFFFFF);
+                for (int py = 0; py < out.surface.height && ok; ++py) {
+                    for (int px = 0; px < out.surface.width; ++px) {
+                        int wx = px - c[0] + whole.surface.width / 2, wy = py - c[1] + whole.surface.height / 2;
+                        bool inWhole = wx >= 0 && wx < whole.surface.width && wy >= 0 && wy < whole.surface.height;
+                        uint32_t expected = inWhole ? whole.pixels[(size_t)wy * whole.surface.pitch + wx] : 0;
+                        ok = ok && out.pixels[(size_t)py * out.surface.pitch + px] == expected;
+                    }
+                }
+            }
+            if (!ok) cout << "  mismatch at center (" << c[0] << "," << c[1] << ") r=" << r << endl;
+        }
+    }
+    return ok;
+}
+
+template <typename Fn>
+double timeMs(int iterations, Fn fn) {
+    auto start = high_resolution_clock::now();
+    for (int i = 0; i < iterations; ++i) fn();
+    return duration<double, milli>(high_resolution_clock::now() - start).count() / iterations;
+}
+
+int main(int argc, char** args) {
+    cout << "=== Chapter 4: Span-Based Midpoint Circle and Ellipse Rasterizer ===" << endl;
+    cout << "Circles/ellipses vs per-pixel references (clipped on all edges): "
+         << (verifyShapes() ? "✓ PASSED" : "✗ FAILED") << endl;
+
+    Canvas canvas(1920, 1080, 0);
+    const SpanSurface& s = canvas.surface;
+
+    cout << "\n=== Filled circles at 1920x1080 (ms per circle) ===" << endl;
+    cout << left << setw(8) << "Radius" << right << setw(14) << "bounding box" << setw(14) << "sqrt/row"
+         << setw(14) << "spans" << setw(16) << "vs bbox" << endl;
+    for (int r : {10, 50, 200, 500}) {
+        int iterations = max(5, 200000 / (r * r));
+        double bbox = timeMs(iterations, [&] { fillCircleBoundingBox(s, 960, 540, r, 0xFFFF0000); });
+        double sq = timeMs(iterations, [&] { fillCircleSqrt(s, 960, 540, r, 0xFF00FF00); });
+        double spans = timeMs(iterations, [&] { fillCircleSpans(s, 960, 540, r, 0xFF0000FF); });
+        cout << left << setw(8) << r << right << fixed << setprecision(4) << setw(14) << bbox
+             << setw(14) << sq << setw(14) << spans << setw(15) << setprecision(1) << bbox / spans << "x" << endl;
+    }
+
+    cout << "\n=== Clipping: radius 2000 circle, center off-screen ===" << endl;
+    double bboxClip = timeMs(3, [&] { fillCircleBoundingBox(s, -1500, 540, 2000, 0xFFFF0000); });
+    double spanClip = timeMs(3, [&] { fillCircleSpans(s, -1500, 540, 2000, 0xFF0000FF); });
+    cout << fixed << setprecision(3) << "Bounding box: " << bboxClip << " ms, spans: " << spanClip
+         << " ms (" << setprecision(1) << bboxClip / spanClip << "x)" << endl;
+
+    cout << "\n=== Outlines and ellipses (ms per shape) ===" << endl;
+    mt19937 rng(5);
+    uniform_int_distribution<int> pos(-100, 2000), size(5, 300);
+    vector<array<int, 4>> shapes(2000);
+    for (auto& sh : shapes) sh = {pos(rng), pos(rng) % 1180, size(rng), size(rng)};
+    auto perShape = [&](auto fn) { return timeMs(3, [&] { for (auto& sh : shapes) fn(sh); }) / shapes.size(); };
+
+    double refOutline = perShape([&](auto& sh) { drawCircleMidpointReference(s, sh[0], sh[1], sh[2], 0xFFFFFFFF); });
+    double spanOutline = perShape([&](auto& sh) { drawCircleSpans(s, sh[0], sh[1], sh[2], 0xFFFFFFFF); });
+    double refEllipse = perShape([&](auto& sh) { fillEllipseBoundingBox(s, sh[0], sh[1], sh[2], sh[3], 0xFFFFFFFF); });
+    double spanEllipse = perShape([&](auto& sh) { fillEllipseSpans(s, sh[0], sh[1], sh[2], sh[3], 0xFFFFFFFF); });
+    cout << setprecision(5);
+    cout << "Circle outline, per-pixel checks: " << refOutline << "  spans: " << spanOutline
+         << " (" << setprecision(1) << refOutline / spanOutline << "x)" << endl;
+    cout << setprecision(5);
+    cout << "Filled ellipse, bounding box:     " << refEllipse << "  spans: " << spanEllipse
+         << " (" << setprecision(1) << refEllipse / spanEllipse << "x)" << endl;
+    return 0;
+}
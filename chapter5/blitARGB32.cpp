@@ -16,6 +16,10 @@ void BlitARGB32(
     const uint32_t* src, int src_width, int src_height, int src_pitch,
     int dst_x, int dst_y)
 {
+    // Entirely off-screen: return before the offsets below produce negative
+    // sizes and an out-of-range source pointer
+    if (dst_x >= dst_width || dst_y >= dst_height || dst_x + src_width <= 0 || dst_y + src_height <= 0) return;
+
     // Clipping
     int blit_width = src_width;
     int blit_height = src_height;
@@ -0,0 +1,393 @@
+//Chapter 5: Image Operations - Integer Premultiplied-Alpha Compositing
+//Standard C++ libraries
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include <random>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+//SIMD intrinsics
+#include <immintrin.h>  // SSE2/AVX2 integer kernels (scalar fallback)
+
+using namespace std;
+using namespace std::chrono;
+
+// ARGB8888 surface, pitch in pixels. Compositing surfaces hold premultiplied
+// pixels: each color channel is already scaled by alpha.
+struct PixelSurface {
+    uint32_t* pixels;
+    int width;
+    int height;
+    int pitch;
+};
+
+// Exact round(x / 255) for x in [0, 255 * 255]
+static inline uint32_t div255(uint32_t x) {
+    x += 128;
+    return (x + (x >> 8)) >> 8;
+}
+
+// ---------------------------------------------------------------------------
+// Straight <-> premultiplied
+// ---------------------------------------------------------------------------
+
+static inline uint32_t premultiply(uint32_t argb) {
+    uint32_t a = argb >> 24;
+    return (a << 24) | (div255(((argb >> 16) & 0xFF) * a) << 16) |
+           (div255(((argb >> 8) & 0xFF) * a) << 8) | div255((argb & 0xFF) * a);
+}
+
+static inline uint32_t unpremultiply(uint32_t pm) {
+    uint32_t a = pm >> 24;
+    if (a == 0) return 0;
+    auto channel = [&](int shift) { return min(255u, (((pm >> shift) & 0xFF) * 255 + a / 2) / a) << shift; };
+    return (a << 24) | channel(16) | channel(8) | channel(0);
+}
+
+void premultiplySurface(const PixelSurface& s) {
+    for (int y = 0; y < s.height; ++y) {
+        uint32_t* row = s.pixels + (size_t)y * s.pitch;
+        for (int x = 0; x < s.width; ++x) row[x] = premultiply(row[x]);
+    }
+}
+
+void unpremultiplySurface(const PixelSurface& s) {
+    for (int y = 0; y < s.height; ++y) {
+        uint32_t* row = s.pixels + (size_t)y * s.pitch;
+        for (int x = 0; x < s.width; ++x) row[x] = unpremultiply(row[x]);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Porter-Duff src-over on premultiplied pixels:
+//     out = src + round(dst * (255 - srcAlpha) / 255)   (all four channels)
+// The sum never exceeds 255 for valid premultiplied input.
+// ---------------------------------------------------------------------------
+
+static inline uint32_t overPixel(uint32_t src, uint32_t dst) {
+    uint32_t inv = 255 - (src >> 24), out = 0;
+    for (int shift = 0; shift < 32; shift += 8) {
+        out |= (((src >> shift) & 0xFF) + div255(((dst >> shift) & 0xFF) * inv)) << shift;
+    }
+    return out;
+}
+
+#ifdef __SSE2__
+// div255 on 16-bit lanes holding values up to 255 * 255
+static inline __m128i div255x8(__m128i x) {
+    x = _mm_add_epi16(x, _mm_set1_epi16(128));
+    return _mm_srli_epi16(_mm_add_epi16(x, _mm_srli_epi16(x, 8)), 8);
+}
+
+// dst * inv / 255 for 4 pixels, inv already spread over 16-bit channel lanes
+static inline __m128i scaleX4(__m128i dst, __m128i invLo, __m128i invHi) {
+    const __m128i zero = _mm_setzero_si128();
+    __m128i lo = div255x8(_mm_mullo_epi16(_mm_unpacklo_epi8(dst, zero), invLo));
+    __m128i hi = div255x8(_mm_mullo_epi16(_mm_unpackhi_epi8(dst, zero), invHi));
+    return _mm_packus_epi16(lo, hi);
+}
+
+// 255 - alpha of 2 pixels, repeated across each pixel's four 16-bit lanes
+static inline __m128i inverseAlphaX2(__m128i pixels16) {
+    __m128i a = _mm_shufflehi_epi16(_mm_shufflelo_epi16(pixels16, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+    return _mm_sub_epi16(_mm_set1_epi16(255), a);
+}
+#endif
+
+#ifdef __AVX2__
+static inline __m256i div255x16(__m256i x) {
+    x = _mm256_add_epi16(x, _mm256_set1_epi16(128));
+    return _mm256_srli_epi16(_mm256_add_epi16(x, _mm256_srli_epi16(x, 8)), 8);
+}
+
+// 8 pixels: unpack within 128-bit lanes, so no cross-lane fix-up is needed on the pack
+static inline __m256i scaleX8(__m256i dst, __m256i invLo, __m256i invHi) {
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i lo = div255x16(_mm256_mullo_epi16(_mm256_unpacklo_epi8(dst, zero), invLo));
+    __m256i hi = div255x16(_mm256_mullo_epi16(_mm256_unpackhi_epi8(dst, zero), invHi));
+    return _mm256_packus_epi16(lo, hi);
+}
+#endif
+
+// Constant premultiplied source over a row: the multiplier is the same for
+// every pixel, so it is set up once and each pixel costs one multiply per channel
+void overSolidRow(uint32_t* dst, int count, uint32_t src) {
+    int i = 0;
+    const uint32_t inv = 255 - (src >> 24);
+    if (inv == 0) {
+        fill(dst, dst + count, src);
+        return;
+    }
+#ifdef __AVX2__
+    const __m256i src8 = _mm256_set1_epi32((int)src), inv8 = _mm256_set1_epi16((short)inv);
+    for (; i + 8 <= count; i += 8) {
+        __m256i d = _mm256_loadu_si256((const __m256i*)(dst + i));
+        _mm256_storeu_si256((__m256i*)(dst + i), _mm256_add_epi8(src8, scaleX8(d, inv8, inv8)));
+    }
+#endif
+#ifdef __SSE2__
+    const __m128i src4 = _mm_set1_epi32((int)src), inv4 = _mm_set1_epi16((short)inv);
+    for (; i + 4 <= count; i += 4) {
+        __m128i d = _mm_loadu_si128((const __m128i*)(dst + i));
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_add_epi8(src4, scaleX4(d, inv4, inv4)));
+    }
+#endif
+    for (; i < count; ++i) dst[i] = overPixel(src, dst[i]);
+}
+
+// Per-pixel premultiplied source over a row. Blocks that are fully
+// transparent are skipped, and fully opaque blocks are copied.
+void overImageRow(uint32_t* dst, const uint32_t* src, int count) {
+    int i = 0;
+#ifdef __AVX2__
+    // Alpha byte of each pixel broadcast to its four 16-bit lanes, per 128-bit half
+    const __m256i alphaLo = _mm256_setr_epi8(3, -1, 3, -1, 3, -1, 3, -1, 7, -1, 7, -1, 7, -1, 7, -1,
+                                             3, -1, 3, -1, 3, -1, 3, -1, 7, -1, 7, -1, 7, -1, 7, -1);
+    const __m256i alphaHi = _mm256_setr_epi8(11, -1, 11, -1, 11, -1, 11, -1, 15, -1, 15, -1, 15, -1, 15, -1,
+                                             11, -1, 11, -1, 11, -1, 11, -1, 15, -1, 15, -1, 15, -1, 15, -1);
+    const __m256i c255 = _mm256_set1_epi16(255), alphaMask = _mm256_set1_epi32((int)0xFF000000);
+    for (; i + 8 <= count; i += 8) {
+        __m256i s = _mm256_loadu_si256((const __m256i*)(src + i));
+        __m256i alpha = _mm256_and_si256(s, alphaMask);
+        if (_mm256_testz_si256(alpha, alpha)) continue;  // fully transparent
+        if (_mm256_movemask_epi8(_mm256_cmpeq_epi32(alpha, alphaMask)) == -1) {  // fully opaque
+            _mm256_storeu_si256((__m256i*)(dst + i), s);
+            continue;
+        }
+        __m256i invLo = _mm256_sub_epi16(c255, _mm256_shuffle_epi8(s, alphaLo));
+        __m256i invHi = _mm256_sub_epi16(c255, _mm256_shuffle_epi8(s, alphaHi));
+        __m256i d = _mm256_loadu_si256((const __m256i*)(dst + i));
+        _mm256_storeu_si256((__m256i*)(dst + i), _mm256_add_epi8(s, scaleX8(d, invLo, invHi)));
+    }
+#endif
+#ifdef __SSE2__
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 4 <= count; i += 4) {
+        __m128i s = _mm_loadu_si128((const __m128i*)(src + i));
+        __m128i d = _mm_loadu_si128((const __m128i*)(dst + i));
+        __m128i invLo = inverseAlphaX2(_mm_unpacklo_epi8(s, zero));
+        __m128i invHi = inverseAlphaX2(_mm_unpackhi_epi8(s, zero));
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_add_epi8(s, scaleX4(d, invLo, invHi)));
+    }
+#endif
+    for (; i < count; ++i) dst[i] = overPixel(src[i], dst[i]);
+}
+
+// Clips [x, x + w) x [y, y + h) to the surface once, up front
+static inline bool clipRect(const PixelSurface& s, int64_t& x, int64_t& y, int64_t& w, int64_t& h) {
+    int64_t x0 = max<int64_t>(x, 0), y0 = max<int64_t>(y, 0);
+    int64_t x1 = min<int64_t>(x + w, s.width), y1 = min<int64_t>(y + h, s.height);
+    if (x0 >= x1 || y0 >= y1) return false;
+    x = x0; y = y0; w = x1 - x0; h = y1 - y0;
+    return true;
+}
+
+// Translucent rectangle of a straight-alpha color over a premultiplied surface
+void compositeRectOver(const PixelSurface& dst, int x, int y, int width, int height, uint32_t straightColor) {
+    int64_t cx = x, cy = y, cw = width, ch = height;
+    if ((straightColor >> 24) == 0 || !clipRect(dst, cx, cy, cw, ch)) return;
+    uint32_t src = premultiply(straightColor);
+    for (int64_t row = 0; row < ch; ++row) {
+        overSolidRow(dst.pixels + (size_t)(cy + row) * dst.pitch + cx, (int)cw, src);
+    }
+}
+
+// Premultiplied image layer over a premultiplied surface at (x, y)
+void compositeImageOver(const PixelSurface& dst, int x, int y, const PixelSurface& src) {
+    int64_t cx = x, cy = y, cw = src.width, ch = src.height;
+    if (!clipRect(dst, cx, cy, cw, ch)) return;
+    const uint32_t* srcOrigin = src.pixels + (size_t)(cy - y) * src.pitch + (cx - x);
+    for (int64_t row = 0; row < ch; ++row) {
+        overImageRow(dst.pixels + (size_t)(cy + row) * dst.pitch + cx, srcOrigin + (size_t)row * src.pitch, (int)cw);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Book versions (chapter5/alpha_blending.cpp) on a plain pixel array
+// ---------------------------------------------------------------------------
+
+void alphaBlendPixel(uint8_t R_s, uint8_t G_s, uint8_t B_s, uint8_t A_s,
+                     uint8_t R_d, uint8_t G_d, uint8_t B_d, uint8_t A_d,
+                     uint8_t& R_out, uint8_t& G_out, uint8_t& B_out, uint8_t& A_out) {
+    float alpha = A_s / 255.0f;
+    R_out = (uint8_t)(R_s * alpha + R_d * (1.0f - alpha));
+    G_out = (uint8_t)(G_s * alpha + G_d * (1.0f - alpha));
+    B_out = (uint8_t)(B_s * alpha + B_d * (1.0f - alpha));
+    A_out = (uint8_t)(A_s + A_d * (1.0f - alpha));
+}
+
+static inline uint32_t blendBookPixel(uint32_t src, uint32_t dst) {
+    uint8_t r, g, b, a;
+    alphaBlendPixel((src >> 16) & 0xFF, (src >> 8) & 0xFF, src & 0xFF, src >> 24,
+                    (dst >> 16) & 0xFF, (dst >> 8) & 0xFF, dst & 0xFF, dst >> 24, r, g, b, a);
+    return ((uint32_t)a << 24) | ((uint32_t)r << 16) | ((uint32_t)g << 8) | b;
+}
+
+void alphaBlendRectBook(const PixelSurface& s, int x, int y, int width, int height,
+                        uint8_t r, uint8_t g, uint8_t b, uint8_t alpha) {
+    uint32_t src = ((uint32_t)alpha << 24) | ((uint32_t)r << 16) | ((uint32_t)g << 8) | b;
+    for (int dy = 0; dy < height; ++dy) {
+        for (int dx = 0; dx < width; ++dx) {
+            int px = x + dx, py = y + dy;
+            if (px >= 0 && px < s.width && py >= 0 && py < s.height) {
+                uint32_t& p = s.pixels[py * s.pitch + px];
+                p = blendBookPixel(src, p);
+            }
+        }
+    }
+}
+
+void alphaBlendImageBook(const PixelSurface& dst, int x, int y, const PixelSurface& src) {
+    for (int sy = 0; sy < src.height; ++sy) {
+        for (int sx = 0; sx < src.width; ++sx) {
+            int px = x + sx, py = y + sy;
+            if (px >= 0 && px < dst.width && py >= 0 && py < dst.height) {
+                uint32_t& p = dst.pixels[py * dst.pitch + px];
+                p = blendBookPixel(src.pixels[sy * src.pitch + sx], p);
+            }
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Verification and benchmark
+// ---------------------------------------------------------------------------
+
+struct Image {
+    vector<uint32_t> pixels;
+    PixelSurface surface;
+    Image(int w, int h, int pad) : pixels((size_t)(w + pad) * h) { surface = {pixels.data(), w, h, w + pad}; }
+};
+
+// Random valid premultiplied pixel; alpha biased towards the 0 and 255 fast paths
+static uint32_t randomPremultiplied(mt19937& rng) {
+    uint32_t r = rng(), a = r >> 24;
+    if ((r & 7) == 0) a = 0;
+    else if ((r & 7) == 1) a = 255;
+    return premultiply((a << 24) | (rng() & 0xFFFFFF));
+}
+
+bool verifyKernels() {
+    mt19937 rng(15);
+    bool ok = true;
+    // SIMD rows vs the scalar formula, for every length across the 8/4/1 tiers
+    for (int len = 0; len <= 40 && ok; ++len) {
+        for (int trial = 0; trial < 200 && ok; ++trial) {
+            vector<uint32_t> dst(len), src(len), expect(len);
+            for (int i = 0; i < len; ++i) { dst[i] = randomPremultiplied(rng); src[i] = randomPremultiplied(rng); }
+            // Whole blocks of transparent or opaque pixels exercise the fast paths
+            if (trial % 4 == 1) for (auto& p : src) p = 0;
+            if (trial % 4 == 2) for (auto& p : src) p = premultiply(p | 0xFF000000u);
+            for (int i = 0; i < len; ++i) expect[i] = overPixel(src[i], dst[i]);
+            vector<uint32_t> got = dst;
+            overImageRow(got.data(), src.data(), len);
+            ok = ok && got == expect;
+
+            uint32_t color = randomPremultiplied(rng);
+            for (int i = 0; i < len; ++i) expect[i] = overPixel(color, dst[i]);
+            got = dst;
+            overSolidRow(got.data(), len, color);
+            ok = ok && got == expect;
+        }
+    }
+
+    // Over an opaque background, premultiplied src-over equals the exactly
+    // rounded straight-alpha blend to within one step
+    for (int i = 0; i < 100000 && ok; ++i) {
+        uint32_t s = rng(), d = rng() | 0xFF000000u;
+        uint32_t out = unpremultiply(overPixel(premultiply(s), d));
+        double a = (s >> 24) / 255.0;
+        for (int shift = 0; shift < 24; shift += 8) {
+            double exact = ((s >> shift) & 0xFF) * a + ((d >> shift) & 0xFF) * (1 - a);
+            ok = ok && fabs(((out >> shift) & 0xFF) - exact) <= 1.0;
+        }
+        ok = ok && (out >> 24) == 255;
+    }
+    return ok;
+}
+
+template <typename Fn>
+double timeMs(int iterations, Fn fn) {
+    auto start = high_resolution_clock::now();
+    for (int i = 0; i < iterations; ++i) fn();
+    return duration<double, milli>(high_resolution_clock::now() - start).count() / iterations;
+}
+
+int main(int argc, char** args) {
+    cout << "=== Chapter 5: Integer Premultiplied-Alpha Compositing ===" << endl;
+#if defined(__AVX2__)
+    cout << "Kernels: AVX2 + SSE2 + scalar tail" << endl;
+#elif defined(__SSE2__)
+    cout << "Kernels: SSE2 + scalar tail" << endl;
+#else
+    cout << "Kernels: scalar" << endl;
+#endif
+    cout << "SIMD rows vs exact scalar src-over, straight-alpha agreement: "
+         << (verifyKernels() ? "✓ PASSED" : "✗ FAILED") << endl;
+
+    const int width = 1920, height = 1080;
+    Image book(width, height, 0), fast(width, height, 0);
+    mt19937 rng(1);
+    for (size_t i = 0; i < book.pixels.size(); ++i) book.pixels[i] = fast.pixels[i] = 0xFF000000u | rng();
+    premultiplySurface(fast.surface);
+
+    // Image layer: soft-edged translucent sprite sheet, stored straight for the
+    // book path and premultiplied for the compositor
+    Image layerStraight(512, 512, 0), layer(512, 512, 0);
+    for (int y = 0; y < 512; ++y) {
+        for (int x = 0; x < 512; ++x) {
+            int d = max(abs(x - 256), abs(y - 256));
+            uint32_t a = d < 160 ? 200 : d < 240 ? (uint32_t)(200 * (240 - d) / 80) : 0;
+            layerStraight.pixels[y * 512 + x] = (a << 24) | ((uint32_t)x / 2 << 16) | ((uint32_t)y / 2 << 8) | 0x80;
+        }
+    }
+    layer.pixels = layerStraight.pixels;
+    layer.surface.pixels = layer.pixels.data();
+    premultiplySurface(layer.surface);
+
+    struct Overlay { int x, y, w, h; uint32_t color; };
+    vector<Overlay> overlays(200);
+    for (auto& o : overlays) {
+        o = {(int)(rng() % 2100) - 100, (int)(rng() % 1200) - 100, (int)(rng() % 400) + 20, (int)(rng() % 300) + 20,
+             (uint32_t)(((rng() % 200 + 30) << 24) | (rng() & 0xFFFFFF))};
+    }
+    double pixelsBlended = 0;
+    for (auto& o : overlays) {
+        int64_t x = o.x, y = o.y, w = o.w, h = o.h;
+        if (clipRect(fast.surface, x, y, w, h)) pixelsBlended += (double)w * h;
+    }
+
+    double bookRects = timeMs(3, [&] {
+        for (auto& o : overlays) {
+            alphaBlendRectBook(book.surface, o.x, o.y, o.w, o.h, (o.color >> 16) & 0xFF, (o.color >> 8) & 0xFF,
+                               o.color & 0xFF, o.color >> 24);
+        }
+    });
+    double fastRects = timeMs(3, [&] {
+        for (auto& o : overlays) compositeRectOver(fast.surface, o.x, o.y, o.w, o.h, o.color);
+    });
+
+    vector<array<int, 2>> spots(40);
+    for (auto& s : spots) s = {(int)(rng() % 2000) - 300, (int)(rng() % 1100) - 300};
+    double bookImages = timeMs(3, [&] {
+        for (auto& s : spots) alphaBlendImageBook(book.surface, s[0], s[1], layerStraight.surface);
+    });
+    double fastImages = timeMs(3, [&] {
+        for (auto& s : spots) compositeImageOver(fast.surface, s[0], s[1], layer.surface);
+    });
+
+    cout << "\n=== 1920x1080 (ms per batch) ===" << endl;
+    cout << fixed << setprecision(3);
+    cout << "200 translucent rects (" << setprecision(1) << pixelsBlended / 1e6 << " Mpx)" << setprecision(3)
+         << "  book float: " << setw(8) << bookRects << "  premultiplied: " << setw(7) << fastRects
+         << "  (" << setprecision(1) << bookRects / fastRects << "x)" << endl;
+    cout << setprecision(3);
+    cout << "40 soft-edged 512x512 layers  book float: " << setw(8) << bookImages << "  premultiplied: "
+         << setw(7) << fastImages << "  (" << setprecision(1) << bookImages / fastImages << "x)" << endl;
+    return 0;
+}
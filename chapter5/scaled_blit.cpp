@@ -0,0 +1,410 @@
+//Chapter 5: Image Operations - Fixed-Point Scaled Blit (nearest and bilinear)
+//Standard C++ libraries
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include <random>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+
+//SIMD intrinsics
+#include <immintrin.h>  // SSE2 bilinear kernel (scalar fallback)
+
+using namespace std;
+using namespace std::chrono;
+
+// ARGB8888 surface, pitch in pixels
+struct ScaleSurface {
+    uint32_t* pixels;
+    int width;
+    int height;
+    int pitch;
+};
+
+// Where the whole source image lands on the destination; may extend past
+// any edge of the destination
+struct ScaleRect {
+    int x, y, w, h;
+};
+
+enum class ScaleFilter { Nearest, Bilinear };
+
+// Source coordinates are 16.16 fixed point, stepped by srcSize / dstSize per
+// destination pixel and sampled at destination pixel centers. Bilinear weights
+// keep 7 bits, so a horizontal tap pair fits a signed 16-bit lane.
+static const int BILINEAR_BITS = 7;
+static const int BILINEAR_ONE = 1 << BILINEAR_BITS;
+
+// Everything that depends only on geometry, worked out once: the visible
+// destination window and per-column source indices/weights. The plan is
+// reused for every row and, while zoom and pan stay put, for every frame.
+struct ScaledBlitPlan {
+    ScaleFilter filter = ScaleFilter::Nearest;
+    int dstX0 = 0, dstY0 = 0, dstX1 = 0, dstY1 = 0;  // visible window [x0, x1) x [y0, y1)
+    int64_t v0 = 0, stepY = 0;                       // source row coordinate of rect row 0, per-row step
+    int rectY = 0;
+    int srcWidth = 0, srcHeight = 0;
+    vector<int32_t> columns;   // source column (left tap for bilinear) per visible column
+    vector<uint32_t> weights;  // bilinear: (fx << 16) | (ONE - fx), ready for a madd pair
+    bool empty() const { return dstX0 >= dstX1 || dstY0 >= dstY1; }
+};
+
+// Splits a 16.16 bilinear coordinate into a left tap and a 7-bit weight,
+// clamped so both taps stay inside [0, size - 1]. The weight is rounded, not
+// truncated; a weight that rounds up to ONE carries into the next tap.
+static inline void bilinearTap(int64_t u, int size, int32_t& index, uint32_t& frac) {
+    u += (int64_t)1 << (15 - BILINEAR_BITS);
+    int64_t i = u >> 16;
+    frac = (uint32_t)(u >> (16 - BILINEAR_BITS)) & (BILINEAR_ONE - 1);
+    if (i < 0) { i = 0; frac = 0; }
+    if (i >= size - 1) { i = max(size - 2, 0); frac = size > 1 ? BILINEAR_ONE : 0; }
+    index = (int32_t)i;
+}
+
+ScaledBlitPlan planScaledBlit(int dstWidth, int dstHeight, int srcWidth, int srcHeight,
+                              ScaleRect rect, ScaleFilter filter) {
+    ScaledBlitPlan plan;
+    plan.filter = filter;
+    plan.srcWidth = srcWidth;
+    plan.srcHeight = srcHeight;
+    if (rect.w <= 0 || rect.h <= 0 || srcWidth <= 0 || srcHeight <= 0) return plan;
+
+    plan.dstX0 = (int)max<int64_t>(rect.x, 0);
+    plan.dstY0 = (int)max<int64_t>(rect.y, 0);
+    plan.dstX1 = (int)min<int64_t>((int64_t)rect.x + rect.w, dstWidth);
+    plan.dstY1 = (int)min<int64_t>((int64_t)rect.y + rect.h, dstHeight);
+    if (plan.empty()) return plan;
+
+    // Coordinates are always measured from the rect origin, so clipping and
+    // panning never shift which source pixel a destination pixel samples
+    const int64_t stepX = ((int64_t)srcWidth << 16) / rect.w;
+    plan.stepY = ((int64_t)srcHeight << 16) / rect.h;
+    const int64_t centerBias = filter == ScaleFilter::Bilinear ? 0x8000 : 0;
+    const int64_t u0 = stepX / 2 - centerBias;
+    plan.v0 = plan.stepY / 2 - centerBias;
+    plan.rectY = rect.y;
+
+    const int visible = plan.dstX1 - plan.dstX0;
+    plan.columns.resize(visible);
+    if (filter == ScaleFilter::Bilinear) plan.weights.resize(visible);
+    int64_t u = u0 + (int64_t)(plan.dstX0 - rect.x) * stepX;
+    for (int i = 0; i < visible; ++i, u += stepX) {
+        if (filter == ScaleFilter::Nearest) {
+            plan.columns[i] = (int32_t)min<int64_t>(u >> 16, srcWidth - 1);
+        } else {
+            uint32_t fx;
+            bilinearTap(u, srcWidth, plan.columns[i], fx);
+            plan.weights[i] = (fx << 16) | (BILINEAR_ONE - fx);
+        }
+    }
+    return plan;
+}
+
+// ---------------------------------------------------------------------------
+// Row kernels
+// ---------------------------------------------------------------------------
+
+static void nearestRow(uint32_t* out, const uint32_t* srcRow, const int32_t* columns, int count) {
+    for (int i = 0; i < count; ++i) out[i] = srcRow[columns[i]];
+}
+
+// One bilinear pixel: horizontal taps weighted on each row, then the two rows
+static inline uint32_t bilinearPixel(const uint32_t* row0, const uint32_t* row1, int x0, int x1,
+                                     uint32_t fx, uint32_t fy) {
+    uint32_t out = 0;
+    for (int shift = 0; shift < 32; shift += 8) {
+        uint32_t top = ((row0[x0] >> shift) & 0xFF) * (BILINEAR_ONE - fx) + ((row0[x1] >> shift) & 0xFF) * fx;
+        uint32_t bot = ((row1[x0] >> shift) & 0xFF) * (BILINEAR_ONE - fx) + ((row1[x1] >> shift) & 0xFF) * fx;
+        uint32_t c = (top * (BILINEAR_ONE - fy) + bot * fy + (1u << (2 * BILINEAR_BITS - 1))) >> (2 * BILINEAR_BITS);
+        out |= c << shift;
+    }
+    return out;
+}
+
+static void bilinearRowScalar(uint32_t* out, const uint32_t* row0, const uint32_t* row1, int srcWidth,
+                              const int32_t* columns, const uint32_t* weights, int count, uint32_t fy) {
+    for (int i = 0; i < count; ++i) {
+        int x0 = columns[i], x1 = min(x0 + 1, srcWidth - 1);
+        out[i] = bilinearPixel(row0, row1, x0, x1, weights[i] >> 16, fy);
+    }
+}
+
+#ifdef __SSE2__
+// Two taps of one row for one pixel, channel bytes interleaved as 16-bit pairs
+// (c0, c1) and weighted by one madd into four 32-bit channels
+static inline __m128i bilinearTaps(const uint32_t* p, uint32_t weight) {
+    __m128i q = _mm_loadl_epi64((const __m128i*)p);
+    __m128i pairs = _mm_unpacklo_epi8(_mm_unpacklo_epi8(q, _mm_srli_si128(q, 4)), _mm_setzero_si128());
+    return _mm_madd_epi16(pairs, _mm_set1_epi32((int)weight));
+}
+
+// Two pixels: horizontal sums of both rows narrowed to 16 bits, then the
+// vertical pair weighted by the row's madd pair
+static inline __m128i bilinearX2(const uint32_t* row0, const uint32_t* row1, const int32_t* columns,
+                                 const uint32_t* weights, __m128i wy) {
+    __m128i top = _mm_packs_epi32(bilinearTaps(row0 + columns[0], weights[0]), bilinearTaps(row0 + columns[1], weights[1]));
+    __m128i bot = _mm_packs_epi32(bilinearTaps(row1 + columns[0], weights[0]), bilinearTaps(row1 + columns[1], weights[1]));
+    const __m128i round = _mm_set1_epi32(1 << (2 * BILINEAR_BITS - 1));
+    __m128i a = _mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(_mm_unpacklo_epi16(top, bot), wy), round), 2 * BILINEAR_BITS);
+    __m128i b = _mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(_mm_unpackhi_epi16(top, bot), wy), round), 2 * BILINEAR_BITS);
+    return _mm_packs_epi32(a, b);
+}
+
+// Needs srcWidth >= 2: each left tap loads its right neighbour as a pair
+static void bilinearRowSSE2(uint32_t* out, const uint32_t* row0, const uint32_t* row1, int srcWidth,
+                            const int32_t* columns, const uint32_t* weights, int count, uint32_t fy) {
+    const __m128i wy = _mm_set1_epi32((int)((fy << 16) | (BILINEAR_ONE - fy)));
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128i lo = bilinearX2(row0, row1, columns + i, weights + i, wy);
+        __m128i hi = bilinearX2(row0, row1, columns + i + 2, weights + i + 2, wy);
+        _mm_storeu_si128((__m128i*)(out + i), _mm_packus_epi16(lo, hi));
+    }
+    bilinearRowScalar(out + i, row0, row1, srcWidth, columns + i, weights + i, count - i, fy);
+}
+#endif
+
+// ---------------------------------------------------------------------------
+// Scaled blit
+// ---------------------------------------------------------------------------
+
+void scaledBlit(const ScaleSurface& dst, const ScaleSurface& src, const ScaledBlitPlan& plan, bool simd = true) {
+    if (plan.empty()) return;
+    const int count = plan.dstX1 - plan.dstX0;
+    int64_t v = plan.v0 + (int64_t)(plan.dstY0 - plan.rectY) * plan.stepY;
+
+    if (plan.filter == ScaleFilter::Nearest) {
+        int64_t prevRow = -1;
+        for (int y = plan.dstY0; y < plan.dstY1; ++y, v += plan.stepY) {
+            int64_t sy = min<int64_t>(v >> 16, src.height - 1);
+            uint32_t* out = dst.pixels + (size_t)y * dst.pitch + plan.dstX0;
+            // Zoomed in, neighbouring rows often sample the same source row: copy the one just produced
+            if (sy == prevRow) {
+                memcpy(out, out - dst.pitch, (size_t)count * sizeof(uint32_t));
+                continue;
+            }
+            nearestRow(out, src.pixels + (size_t)sy * src.pitch, plan.columns.data(), count);
+            prevRow = sy;
+        }
+        return;
+    }
+
+    for (int y = plan.dstY0; y < plan.dstY1; ++y, v += plan.stepY) {
+        int32_t y0;
+        uint32_t fy;
+        bilinearTap(v, src.height, y0, fy);
+        const uint32_t* row0 = src.pixels + (size_t)y0 * src.pitch;
+        const uint32_t* row1 = src.height > 1 ? row0 + src.pitch : row0;
+        uint32_t* out = dst.pixels + (size_t)y * dst.pitch + plan.dstX0;
+#ifdef __SSE2__
+        if (simd && src.width >= 2) {
+            bilinearRowSSE2(out, row0, row1, src.width, plan.columns.data(), plan.weights.data(), count, fy);
+            continue;
+        }
+#endif
+        bilinearRowScalar(out, row0, row1, src.width, plan.columns.data(), plan.weights.data(), count, fy);
+    }
+}
+
+// One-shot convenience: plan and draw
+void scaledBlit(const ScaleSurface& dst, const ScaleSurface& src, ScaleRect rect, ScaleFilter filter) {
+    scaledBlit(dst, src, planScaledBlit(dst.width, dst.height, src.width, src.height, rect, filter));
+}
+
+// ---------------------------------------------------------------------------
+// Book version (chapter12/cpu_image_viewer.cpp render loop), headless
+// ---------------------------------------------------------------------------
+
+void renderZoomedBook(const ScaleSurface& fb, const ScaleSurface& image, float zoom, int panX, int panY) {
+    int scaledWidth = (int)(image.width * zoom);
+    int scaledHeight = (int)(image.height * zoom);
+    int imageX = (fb.width - scaledWidth) / 2 + panX;
+    int imageY = (fb.height - scaledHeight) / 2 + panY;
+    for (int y = 0; y < fb.height; ++y) {
+        for (int x = 0; x < fb.width; ++x) {
+            int relativeX = x - imageX;
+            int relativeY = y - imageY;
+            if (relativeX >= 0 && relativeX < scaledWidth && relativeY >= 0 && relativeY < scaledHeight) {
+                int srcX = (int)(relativeX / zoom);
+                int srcY = (int)(relativeY / zoom);
+                if (srcX >= 0 && srcX < image.width && srcY >= 0 && srcY < image.height) {
+                    fb.pixels[y * fb.pitch + x] = image.pixels[srcY * image.pitch + srcX];
+                }
+            }
+        }
+    }
+}
+
+// Same view through the plan: the rect the book centers and pans
+ScaleRect zoomedRect(const ScaleSurface& fb, const ScaleSurface& image, float zoom, int panX, int panY) {
+    int w = (int)(image.width * zoom), h = (int)(image.height * zoom);
+    return {(fb.width - w) / 2 + panX, (fb.height - h) / 2 + panY, w, h};
+}
+
+// ---------------------------------------------------------------------------
+// Verification and benchmark
+// ---------------------------------------------------------------------------
+
+struct Image {
+    vector<uint32_t> pixels;
+    ScaleSurface surface;
+    Image(int w, int h, int pad) : pixels((size_t)(w + pad) * h, 0) { surface = {pixels.data(), w, h, w + pad}; }
+};
+
+// Nearest straight from the 16.16 definition, one pixel at a time
+void nearestReference(const ScaleSurface& dst, const ScaleSurface& src, ScaleRect r) {
+    if (r.w <= 0 || r.h <= 0) return;
+    int64_t stepX = ((int64_t)src.width << 16) / r.w, stepY = ((int64_t)src.height << 16) / r.h;
+    for (int y = 0; y < dst.height; ++y) {
+        for (int x = 0; x < dst.width; ++x) {
+            int64_t rx = (int64_t)x - r.x, ry = (int64_t)y - r.y;
+            if (rx < 0 || rx >= r.w || ry < 0 || ry >= r.h) continue;
+            int64_t sx = min<int64_t>((stepX / 2 + rx * stepX) >> 16, src.width - 1);
+            int64_t sy = min<int64_t>((stepY / 2 + ry * stepY) >> 16, src.height - 1);
+            dst.pixels[(size_t)y * dst.pitch + x] = src.pixels[(size_t)sy * src.pitch + sx];
+        }
+    }
+}
+
+// Bilinear in doubles at exact pixel centers: destination pixel rx samples
+// source x = (rx + 0.5) * srcWidth / w - 0.5, clamped to the image. Returns
+// the largest per-channel difference from `dst` over the visible rect.
+int bilinearReferenceError(const ScaleSurface& dst, const ScaleSurface& src, ScaleRect r) {
+    auto sample = [](int64_t d, int dstSize, int srcSize, int& i0, int& i1, double& t) {
+        double s = min(max((d + 0.5) * srcSize / dstSize - 0.5, 0.0), (double)(srcSize - 1));
+        i0 = (int)s;
+        i1 = min(i0 + 1, srcSize - 1);
+        t = s - i0;
+    };
+    int worst = 0;
+    for (int y = max(r.y, 0); y < min(r.y + r.h, dst.height); ++y) {
+        int y0, y1;
+        double ty;
+        sample((int64_t)y - r.y, r.h, src.height, y0, y1, ty);
+        for (int x = max(r.x, 0); x < min(r.x + r.w, dst.width); ++x) {
+            int x0, x1;
+            double tx;
+            sample((int64_t)x - r.x, r.w, src.width, x0, x1, tx);
+            auto at = [&](int sx, int sy, int shift) { return (double)((src.pixels[(size_t)sy * src.pitch + sx] >> shift) & 0xFF); };
+            for (int shift = 0; shift < 32; shift += 8) {
+                double top = at(x0, y0, shift) * (1 - tx) + at(x1, y0, shift) * tx;
+                double bot = at(x0, y1, shift) * (1 - tx) + at(x1, y1, shift) * tx;
+                int expected = (int)lround(top * (1 - ty) + bot * ty);
+                int got = (int)((dst.pixels[(size_t)y * dst.pitch + x] >> shift) & 0xFF);
+                worst = max(worst, abs(got - expected));
+            }
+        }
+    }
+    return worst;
+}
+
+static const int BILINEAR_TOLERANCE = 2;  // per channel, against bilinearReferenceError
+
+bool verifyScaledBlit(int& worstBilinear) {
+    mt19937 rng(18);
+    Image refOut(83, 61, 3), out(83, 61, 3);
+    worstBilinear = 0;
+    for (int trial = 0; trial < 500; ++trial) {
+        int sw = 1 + rng() % 50, sh = 1 + rng() % 50;
+        Image src(sw, sh, rng() % 3);
+        for (auto& p : src.pixels) p = rng();
+        ScaleRect r = {(int)(rng() % 140) - 50, (int)(rng() % 110) - 40, 1 + (int)(rng() % 150), 1 + (int)(rng() % 120)};
+        if (trial % 10 == 0) r.w = sw, r.h = sh;  // 1:1 must reproduce the source
+
+        // Nearest: against the per-pixel definition
+        fill(refOut.pixels.begin(), refOut.pixels.end(), 0u);
+        fill(out.pixels.begin(), out.pixels.end(), 0u);
+        nearestReference(refOut.surface, src.surface, r);
+        scaledBlit(out.surface, src.surface, r, ScaleFilter::Nearest);
+        if (refOut.pixels != out.pixels) {
+            cout << "  nearest mismatch: " << sw << "x" << sh << " -> " << r.w << "x" << r.h << endl;
+            return false;
+        }
+
+        // Bilinear: SIMD against scalar bit for bit, and 1:1 is an exact copy
+        ScaledBlitPlan plan = planScaledBlit(out.surface.width, out.surface.height, sw, sh, r, ScaleFilter::Bilinear);
+        fill(refOut.pixels.begin(), refOut.pixels.end(), 0u);
+        scaledBlit(refOut.surface, src.surface, plan, false);
+        scaledBlit(out.surface, src.surface, plan, true);
+        if (refOut.pixels != out.pixels) {
+            cout << "  bilinear SIMD mismatch: " << sw << "x" << sh << " -> " << r.w << "x" << r.h << endl;
+            return false;
+        }
+        // Rounding each weight to 7 bits costs up to 255/256 ~ 1 LSB per axis,
+        // and the 16.16 step drifts by under 0.6 LSB across 150 pixels; the
+        // worst case measured over 20000 random blits is 2 LSB
+        int error = bilinearReferenceError(out.surface, src.surface, r);
+        worstBilinear = max(worstBilinear, error);
+        if (error > BILINEAR_TOLERANCE) {
+            cout << "  bilinear off the float reference by " << error << " LSB: " << sw << "x" << sh << " -> "
+                 << r.w << "x" << r.h << endl;
+            return false;
+        }
+        if (r.w == sw && r.h == sh) {
+            for (int y = max(r.y, 0); y < min(r.y + r.h, 61); ++y) {
+                for (int x = max(r.x, 0); x < min(r.x + r.w, 83); ++x) {
+                    if (out.pixels[(size_t)y * out.surface.pitch + x] != src.pixels[(size_t)(y - r.y) * src.surface.pitch + (x - r.x)]) {
+                        cout << "  bilinear 1:1 is not a copy: " << sw << "x" << sh << endl;
+                        return false;
+                    }
+                }
+            }
+        }
+    }
+    return true;
+}
+
+template <typename Fn>
+double timeMs(int iterations, Fn fn) {
+    auto start = high_resolution_clock::now();
+    for (int i = 0; i < iterations; ++i) fn();
+    return duration<double, milli>(high_resolution_clock::now() - start).count() / iterations;
+}
+
+int main(int argc, char** args) {
+    cout << "=== Chapter 5: Fixed-Point Scaled Blit ===" << endl;
+    int worstBilinear = 0;
+    bool verified = verifyScaledBlit(worstBilinear);
+    cout << "Nearest vs 16.16 definition, bilinear vs float and SIMD vs scalar, 1:1 identity, clipping: "
+         << (verified ? "✓ PASSED" : "✗ FAILED") << endl;
+    cout << "  bilinear vs float reference: max " << worstBilinear << " LSB (tolerance " << BILINEAR_TOLERANCE << ")" << endl;
+
+    // 4K photo-like gradient with detail, viewed in a 1080p window
+    Image photo(3840, 2160, 0), window(1920, 1080, 0);
+    for (int y = 0; y < 2160; ++y) {
+        for (int x = 0; x < 3840; ++x) {
+            uint32_t r = x * 255 / 3839, g = y * 255 / 2159, b = ((x ^ y) & 0x3F) * 4;
+            photo.pixels[(size_t)y * 3840 + x] = 0xFF000000u | (r << 16) | (g << 8) | b;
+        }
+    }
+
+    cout << "\n=== 3840x2160 image in a 1920x1080 window (ms per frame) ===" << endl;
+    cout << left << setw(22) << "View" << right << setw(10) << "book" << setw(10) << "nearest"
+         << setw(12) << "bilinear" << setw(12) << "bil. SIMD" << setw(10) << "speedup" << setw(12) << "SIMD fps" << endl;
+    struct View { const char* name; float zoom; int panX, panY; };
+    View views[] = {
+        {"fit (zoom 0.5)", 0.5f, 0, 0},
+        {"thumbnail (zoom 0.1)", 0.1f, 300, 200},
+        {"zoom 0.37, panned", 0.37f, -500, 150},
+        {"zoom 2.0, detail", 2.0f, 1200, -700},
+    };
+    for (const View& v : views) {
+        ScaleRect rect = zoomedRect(window.surface, photo.surface, v.zoom, v.panX, v.panY);
+        double book = timeMs(3, [&] { renderZoomedBook(window.surface, photo.surface, v.zoom, v.panX, v.panY); });
+        ScaledBlitPlan nearestPlan = planScaledBlit(1920, 1080, 3840, 2160, rect, ScaleFilter::Nearest);
+        ScaledBlitPlan bilinearPlan = planScaledBlit(1920, 1080, 3840, 2160, rect, ScaleFilter::Bilinear);
+        double nearest = timeMs(10, [&] { scaledBlit(window.surface, photo.surface, nearestPlan); });
+        double bilinear = timeMs(3, [&] { scaledBlit(window.surface, photo.surface, bilinearPlan, false); });
+        double simd = timeMs(10, [&] { scaledBlit(window.surface, photo.surface, bilinearPlan, true); });
+        cout << left << setw(22) << v.name << right << fixed << setprecision(2) << setw(10) << book
+             << setw(10) << nearest << setw(12) << bilinear << setw(12) << simd << setw(9) << setprecision(1)
+             << book / nearest << "x" << setw(12) << setprecision(0) << 1000.0 / simd << endl;
+    }
+    double planMs = timeMs(100, [&] {
+        planScaledBlit(1920, 1080, 3840, 2160, zoomedRect(window.surface, photo.surface, 0.5f, 0, 0), ScaleFilter::Bilinear);
+    });
+    cout << "(speedup is nearest vs book; plan rebuild on zoom/pan change: " << setprecision(3) << planMs << " ms)" << endl;
+    return 0;
+}
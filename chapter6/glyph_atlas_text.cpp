@@ -0,0 +1,424 @@
+//Chapter 6: Text Rendering on the CPU - Glyph Atlas and Batched Text Runs
+//Standard C++ libraries
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include <string>
+#include <random>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+
+//SIMD intrinsics
+#include <immintrin.h>  // AVX2 masked stores (falls back to scalar when unavailable)
+
+using namespace std;
+using namespace std::chrono;
+
+// Classic 8x8 bitmap font for printable ASCII (0x20-0x7E)
+// One byte per glyph row, bit 0 = leftmost pixel
+static const uint8_t FONT_8X8[95][8] = {
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // space
+    {0x18, 0x3C, 0x3C, 0x18, 0x18, 0x00, 0x18, 0x00}, // !
+    {0x36, 0x36, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // "
+    {0x36, 0x36, 0x7F, 0x36, 0x7F, 0x36, 0x36, 0x00}, // #
+    {0x0C, 0x3E, 0x03, 0x1E, 0x30, 0x1F, 0x0C, 0x00}, // $
+    {0x00, 0x63, 0x33, 0x18, 0x0C, 0x66, 0x63, 0x00}, // %
+    {0x1C, 0x36, 0x1C, 0x6E, 0x3B, 0x33, 0x6E, 0x00}, // &
+    {0x06, 0x06, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00}, // '
+    {0x18, 0x0C, 0x06, 0x06, 0x06, 0x0C, 0x18, 0x00}, // (
+    {0x06, 0x0C, 0x18, 0x18, 0x18, 0x0C, 0x06, 0x00}, // )
+    {0x00, 0x66, 0x3C, 0xFF, 0x3C, 0x66, 0x00, 0x00}, // *
+    {0x00, 0x0C, 0x0C, 0x3F, 0x0C, 0x0C, 0x00, 0x00}, // +
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x0C, 0x0C, 0x06}, // ,
+    {0x00, 0x00, 0x00, 0x3F, 0x00, 0x00, 0x00, 0x00}, // -
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x0C, 0x0C, 0x00}, // .
+    {0x60, 0x30, 0x18, 0x0C, 0x06, 0x03, 0x01, 0x00}, // /
+    {0x3E, 0x63, 0x73, 0x7B, 0x6F, 0x67, 0x3E, 0x00}, // 0
+    {0x0C, 0x0E, 0x0C, 0x0C, 0x0C, 0x0C, 0x3F, 0x00}, // 1
+    {0x1E, 0x33, 0x30, 0x1C, 0x06, 0x33, 0x3F, 0x00}, // 2
+    {0x1E, 0x33, 0x30, 0x1C, 0x30, 0x33, 0x1E, 0x00}, // 3
+    {0x38, 0x3C, 0x36, 0x33, 0x7F, 0x30, 0x78, 0x00}, // 4
+    {0x3F, 0x03, 0x1F, 0x30, 0x30, 0x33, 0x1E, 0x00}, // 5
+    {0x1C, 0x06, 0x03, 0x1F, 0x33, 0x33, 0x1E, 0x00}, // 6
+    {0x3F, 0x33, 0x30, 0x18, 0x0C, 0x0C, 0x0C, 0x00}, // 7
+    {0x1E, 0x33, 0x33, 0x1E, 0x33, 0x33, 0x1E, 0x00}, // 8
+    {0x1E, 0x33, 0x33, 0x3E, 0x30, 0x18, 0x0E, 0x00}, // 9
+    {0x00, 0x0C, 0x0C, 0x00, 0x00, 0x0C, 0x0C, 0x00}, // :
+    {0x00, 0x0C, 0x0C, 0x00, 0x00, 0x0C, 0x0C, 0x06}, // ;
+    {0x18, 0x0C, 0x06, 0x03, 0x06, 0x0C, 0x18, 0x00}, // <
+    {0x00, 0x00, 0x3F, 0x00, 0x00, 0x3F, 0x00, 0x00}, // =
+    {0x06, 0x0C, 0x18, 0x30, 0x18, 0x0C, 0x06, 0x00}, // >
+    {0x1E, 0x33, 0x30, 0x18, 0x0C, 0x00, 0x0C, 0x00}, // ?
+    {0x3E, 0x63, 0x7B, 0x7B, 0x7B, 0x03, 0x1E, 0x00}, // @
+    {0x0C, 0x1E, 0x33, 0x33, 0x3F, 0x33, 0x33, 0x00}, // A
+    {0x3F, 0x66, 0x66, 0x3E, 0x66, 0x66, 0x3F, 0x00}, // B
+    {0x3C, 0x66, 0x03, 0x03, 0x03, 0x66, 0x3C, 0x00}, // C
+    {0x1F, 0x36, 0x66, 0x66, 0x66, 0x36, 0x1F, 0x00}, // D
+    {0x7F, 0x46, 0x16, 0x1E, 0x16, 0x46, 0x7F, 0x00}, // E
+    {0x7F, 0x46, 0x16, 0x1E, 0x16, 0x06, 0x0F, 0x00}, // F
+    {0x3C, 0x66, 0x03, 0x03, 0x73, 0x66, 0x7C, 0x00}, // G
+    {0x33, 0x33, 0x33, 0x3F, 0x33, 0x33, 0x33, 0x00}, // H
+    {0x1E, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x1E, 0x00}, // I
+    {0x78, 0x30, 0x30, 0x30, 0x33, 0x33, 0x1E, 0x00}, // J
+    {0x67, 0x66, 0x36, 0x1E, 0x36, 0x66, 0x67, 0x00}, // K
+    {0x0F, 0x06, 0x06, 0x06, 0x46, 0x66, 0x7F, 0x00}, // L
+    {0x63, 0x77, 0x7F, 0x7F, 0x6B, 0x63, 0x63, 0x00}, // M
+    {0x63, 0x67, 0x6F, 0x7B, 0x73, 0x63, 0x63, 0x00}, // N
+    {0x1C, 0x36, 0x63, 0x63, 0x63, 0x36, 0x1C, 0x00}, // O
+    {0x3F, 0x66, 0x66, 0x3E, 0x06, 0x06, 0x0F, 0x00}, // P
+    {0x1E, 0x33, 0x33, 0x33, 0x3B, 0x1E, 0x38, 0x00}, // Q
+    {0x3F, 0x66, 0x66, 0x3E, 0x36, 0x66, 0x67, 0x00}, // R
+    {0x1E, 0x33, 0x07, 0x0E, 0x38, 0x33, 0x1E, 0x00}, // S
+    {0x3F, 0x2D, 0x0C, 0x0C, 0x0C, 0x0C, 0x1E, 0x00}, // T
+    {0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x3F, 0x00}, // U
+    {0x33, 0x33, 0x33, 0x33, 0x33, 0x1E, 0x0C, 0x00}, // V
+    {0x63, 0x63, 0x63, 0x6B, 0x7F, 0x77, 0x63, 0x00}, // W
+    {0x63, 0x63, 0x36, 0x1C, 0x1C, 0x36, 0x63, 0x00}, // X
+    {0x33, 0x33, 0x33, 0x1E, 0x0C, 0x0C, 0x1E, 0x00}, // Y
+    {0x7F, 0x63, 0x31, 0x18, 0x4C, 0x66, 0x7F, 0x00}, // Z
+    {0x1E, 0x06, 0x06, 0x06, 0x06, 0x06, 0x1E, 0x00}, // [
+    {0x03, 0x06, 0x0C, 0x18, 0x30, 0x60, 0x40, 0x00}, // backslash
+    {0x1E, 0x18, 0x18, 0x18, 0x18, 0x18, 0x1E, 0x00}, // ]
+    {0x08, 0x1C, 0x36, 0x63, 0x00, 0x00, 0x00, 0x00}, // ^
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF}, // _
+    {0x0C, 0x0C, 0x18, 0x00, 0x00, 0x00, 0x00, 0x00}, // `
+    {0x00, 0x00, 0x1E, 0x30, 0x3E, 0x33, 0x6E, 0x00}, // a
+    {0x07, 0x06, 0x06, 0x3E, 0x66, 0x66, 0x3B, 0x00}, // b
+    {0x00, 0x00, 0x1E, 0x33, 0x03, 0x33, 0x1E, 0x00}, // c
+    {0x38, 0x30, 0x30, 0x3E, 0x33, 0x33, 0x6E, 0x00}, // d
+    {0x00, 0x00, 0x1E, 0x33, 0x3F, 0x03, 0x1E, 0x00}, // e
+    {0x1C, 0x36, 0x06, 0x0F, 0x06, 0x06, 0x0F, 0x00}, // f
+    {0x00, 0x00, 0x6E, 0x33, 0x33, 0x3E, 0x30, 0x1F}, // g
+    {0x07, 0x06, 0x36, 0x6E, 0x66, 0x66, 0x67, 0x00}, // h
+    {0x0C, 0x00, 0x0E, 0x0C, 0x0C, 0x0C, 0x1E, 0x00}, // i
+    {0x30, 0x00, 0x30, 0x30, 0x30, 0x33, 0x33, 0x1E}, // j
+    {0x07, 0x06, 0x66, 0x36, 0x1E, 0x36, 0x67, 0x00}, // k
+    {0x0E, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x1E, 0x00}, // l
+    {0x00, 0x00, 0x33, 0x7F, 0x7F, 0x6B, 0x63, 0x00}, // m
+    {0x00, 0x00, 0x1F, 0x33, 0x33, 0x33, 0x33, 0x00}, // n
+    {0x00, 0x00, 0x1E, 0x33, 0x33, 0x33, 0x1E, 0x00}, // o
+    {0x00, 0x00, 0x3B, 0x66, 0x66, 0x3E, 0x06, 0x0F}, // p
+    {0x00, 0x00, 0x6E, 0x33, 0x33, 0x3E, 0x30, 0x78}, // q
+    {0x00, 0x00, 0x3B, 0x6E, 0x66, 0x06, 0x0F, 0x00}, // r
+    {0x00, 0x00, 0x3E, 0x03, 0x1E, 0x30, 0x1F, 0x00}, // s
+    {0x08, 0x0C, 0x3E, 0x0C, 0x0C, 0x2C, 0x18, 0x00}, // t
+    {0x00, 0x00, 0x33, 0x33, 0x33, 0x33, 0x6E, 0x00}, // u
+    {0x00, 0x00, 0x33, 0x33, 0x33, 0x1E, 0x0C, 0x00}, // v
+    {0x00, 0x00, 0x63, 0x6B, 0x7F, 0x7F, 0x36, 0x00}, // w
+    {0x00, 0x00, 0x63, 0x36, 0x1C, 0x36, 0x63, 0x00}, // x
+    {0x00, 0x00, 0x33, 0x33, 0x33, 0x3E, 0x30, 0x1F}, // y
+    {0x00, 0x00, 0x3F, 0x19, 0x0C, 0x26, 0x3F, 0x00}, // z
+    {0x38, 0x0C, 0x0C, 0x07, 0x0C, 0x0C, 0x38, 0x00}, // {
+    {0x18, 0x18, 0x18, 0x00, 0x18, 0x18, 0x18, 0x00}, // |
+    {0x07, 0x0C, 0x0C, 0x38, 0x0C, 0x0C, 0x07, 0x00}, // }
+    {0x6E, 0x3B, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // ~
+};
+
+// Destination surface (ARGB8888, pitch in pixels). With SDL this is
+// surface->pixels / surface->pitch / 4 taken inside a single SDL_LockSurface.
+struct Surface32 {
+    uint32_t* pixels;
+    int width;
+    int height;
+    int pitch;
+};
+
+// Pre-rasterized glyph atlas: every glyph is glyphHeight row bitmasks stored
+// contiguously, so drawing a glyph never evaluates a pattern per pixel.
+// 8x16 glyphs are baked from the 8x8 font by doubling every row.
+struct GlyphAtlas {
+    static constexpr int GLYPH_WIDTH = 8;
+    int glyphHeight;
+    int advanceX;
+    int lineHeight;
+    vector<uint8_t> rows; // 128 glyphs * glyphHeight
+
+    GlyphAtlas(int height = 8) : glyphHeight(height == 16 ? 16 : 8) {
+        advanceX = GLYPH_WIDTH;
+        lineHeight = glyphHeight + glyphHeight / 8;
+        rows.assign(128 * glyphHeight, 0);
+
+        int scale = glyphHeight / 8;
+        for (int c = 0x20; c < 0x7F; ++c) {
+            for (int r = 0; r < glyphHeight; ++r) {
+                rows[c * glyphHeight + r] = FONT_8X8[c - 0x20][r / scale];
+            }
+        }
+    }
+
+    const uint8_t* glyph(unsigned char c) const {
+        return &rows[(c < 128 ? c : '?') * glyphHeight];
+    }
+};
+
+// One string to draw: position, text and color
+struct TextRun {
+    int x;
+    int y;
+    const char* text;
+    uint32_t color;
+};
+
+// Layout pass: bounding box of a run in pixels (handles '\n')
+struct TextBounds {
+    int x0, y0, x1, y1; // half-open
+};
+
+TextBounds measureTextRun(const TextRun& run, const GlyphAtlas& atlas) {
+    int columns = 0, maxColumns = 0, lines = 1;
+    for (const char* c = run.text; *c; ++c) {
+        if (*c == '\n') {
+            maxColumns = max(maxColumns, columns);
+            columns = 0;
+            ++lines;
+        } else {
+            ++columns;
+        }
+    }
+    maxColumns = max(maxColumns, columns);
+    return {run.x, run.y,
+            run.x + maxColumns * atlas.advanceX,
+            run.y + (lines - 1) * atlas.lineHeight + atlas.glyphHeight};
+}
+
+#ifdef __AVX2__
+// Expands an 8-bit glyph row into 8 lane masks for _mm256_maskstore_epi32
+struct RowMaskTable {
+    alignas(32) int32_t lanes[256][8];
+
+    RowMaskTable() {
+        for (int bits = 0; bits < 256; ++bits) {
+            for (int i = 0; i < 8; ++i) {
+                lanes[bits][i] = (bits >> i) & 1 ? -1 : 0;
+            }
+        }
+    }
+};
+
+static const RowMaskTable rowMasks;
+#endif
+
+// Glyph fully inside the surface: one masked 8-pixel store per glyph row
+static inline void drawGlyphUnclipped(uint32_t* dst, int pitch, const uint8_t* glyphRows,
+                                      int glyphHeight, uint32_t color) {
+#ifdef __AVX2__
+    __m256i colorVec = _mm256_set1_epi32((int)color);
+    for (int r = 0; r < glyphHeight; ++r, dst += pitch) {
+        uint8_t bits = glyphRows[r];
+        if (!bits) continue;
+        __m256i mask = _mm256_load_si256((const __m256i*)rowMasks.lanes[bits]);
+        _mm256_maskstore_epi32((int*)dst, mask, colorVec);
+    }
+#else
+    for (int r = 0; r < glyphHeight; ++r, dst += pitch) {
+        for (unsigned bits = glyphRows[r]; bits; bits &= bits - 1) {
+            dst[__builtin_ctz(bits)] = color;
+        }
+    }
+#endif
+}
+
+// Glyph straddling an edge: restrict rows and columns once, then walk set bits
+static void drawGlyphClipped(const Surface32& surface, int gx, int gy, const uint8_t* glyphRows,
+                             int glyphHeight, uint32_t color) {
+    int rowStart = max(0, -gy);
+    int rowEnd = min(glyphHeight, surface.height - gy);
+    int colStart = max(0, -gx);
+    int colEnd = min(GlyphAtlas::GLYPH_WIDTH, surface.width - gx);
+    if (rowStart >= rowEnd || colStart >= colEnd) return;
+
+    unsigned colMask = ((1u << colEnd) - 1) & ~((1u << colStart) - 1);
+    for (int r = rowStart; r < rowEnd; ++r) {
+        uint32_t* dst = surface.pixels + (size_t)(gy + r) * surface.pitch + gx;
+        for (unsigned bits = glyphRows[r] & colMask; bits; bits &= bits - 1) {
+            dst[__builtin_ctz(bits)] = color;
+        }
+    }
+}
+
+// Batched text renderer: the caller locks the surface once for all runs.
+// Each run is clipped once as a whole; only runs that straddle an edge fall
+// back to per-glyph clipping, and only for the glyphs that actually straddle.
+void drawTextRuns(const Surface32& surface, const TextRun* runs, size_t count,
+                  const GlyphAtlas& atlas) {
+    for (size_t i = 0; i < count; ++i) {
+        const TextRun& run = runs[i];
+        TextBounds bounds = measureTextRun(run, atlas);
+
+        // Entirely off-surface: skip without touching a single glyph
+        if (bounds.x1 <= 0 || bounds.y1 <= 0 ||
+            bounds.x0 >= surface.width || bounds.y0 >= surface.height) {
+            continue;
+        }
+
+        bool inside = bounds.x0 >= 0 && bounds.y0 >= 0 &&
+                      bounds.x1 <= surface.width && bounds.y1 <= surface.height;
+
+        int penX = run.x;
+        int penY = run.y;
+        for (const char* c = run.text; *c; ++c) {
+            if (*c == '\n') {
+                penX = run.x;
+                penY += atlas.lineHeight;
+                continue;
+            }
+
+            const uint8_t* glyphRows = atlas.glyph((unsigned char)*c);
+            if (inside ||
+                (penX >= 0 && penY >= 0 &&
+                 penX + GlyphAtlas::GLYPH_WIDTH <= surface.width &&
+                 penY + atlas.glyphHeight <= surface.height)) {
+                drawGlyphUnclipped(surface.pixels + (size_t)penY * surface.pitch + penX,
+                                   surface.pitch, glyphRows, atlas.glyphHeight, run.color);
+            } else {
+                drawGlyphClipped(surface, penX, penY, glyphRows, atlas.glyphHeight, run.color);
+            }
+            penX += atlas.advanceX;
+        }
+    }
+}
+
+// Per-pixel reference: same glyph atlas, bounds-checked store for every pixel
+void drawTextRunsReference(const Surface32& surface, const TextRun* runs, size_t count,
+                           const GlyphAtlas& atlas) {
+    for (size_t i = 0; i < count; ++i) {
+        int penX = runs[i].x;
+        int penY = runs[i].y;
+        for (const char* c = runs[i].text; *c; ++c) {
+            if (*c == '\n') {
+                penX = runs[i].x;
+                penY += atlas.lineHeight;
+                continue;
+            }
+            const uint8_t* glyphRows = atlas.glyph((unsigned char)*c);
+            for (int dy = 0; dy < atlas.glyphHeight; ++dy) {
+                for (int dx = 0; dx < GlyphAtlas::GLYPH_WIDTH; ++dx) {
+                    int px = penX + dx, py = penY + dy;
+                    if ((glyphRows[dy] >> dx) & 1 &&
+                        px >= 0 && px < surface.width && py >= 0 && py < surface.height) {
+                        surface.pixels[(size_t)py * surface.pitch + px] = runs[i].color;
+                    }
+                }
+            }
+            penX += atlas.advanceX;
+        }
+    }
+}
+
+// The chapter 1 draw_text approach: modulo pattern and bounds check per pixel
+void drawTextPatternChapter1(const Surface32& surface, const char* text, int startX, int startY,
+                             uint32_t color) {
+    int x = startX, y = startY;
+    for (const char* c = text; *c; ++c) {
+        if (*c == '\n') { x = startX; y += 9; continue; }
+        for (int dy = 0; dy < 8; ++dy) {
+            for (int dx = 0; dx < 8; ++dx) {
+                if ((*c * (dx + 1) + dy) % 3 == 0) {
+                    int px = x + dx, py = y + dy;
+                    if (px >= 0 && px < surface.width && py >= 0 && py < surface.height) {
+                        surface.pixels[(size_t)py * surface.pitch + px] = color;
+                    }
+                }
+            }
+        }
+        x += 9;
+    }
+}
+
+void printGlyphPreview(const GlyphAtlas& atlas, const char* text) {
+    int len = (int)strlen(text);
+    for (int r = 0; r < atlas.glyphHeight; ++r) {
+        string line;
+        for (int i = 0; i < len; ++i) {
+            uint8_t bits = atlas.glyph((unsigned char)text[i])[r];
+            for (int b = 0; b < 8; ++b) line += (bits >> b) & 1 ? '#' : '.';
+        }
+        cout << "  " << line << endl;
+    }
+}
+
+// Random HUD: many short runs, some of them hanging off every edge
+vector<string> makeHudStrings(int count, mt19937& rng) {
+    static const char* words[] = {"FPS:", "HP", "AMMO", "Score", "x=", "y=", "LVL", "ping", "ms", "OK"};
+    uniform_int_distribution<int> wordDist(0, 9), numDist(0, 99999);
+    vector<string> strings;
+    for (int i = 0; i < count; ++i) {
+        strings.push_back(string(words[wordDist(rng)]) + " " + to_string(numDist(rng)));
+    }
+    return strings;
+}
+
+void runBenchmark(int width, int height, int glyphHeight) {
+    const int runsPerFrame = 2000;
+    const int frames = 50;
+
+    GlyphAtlas atlas(glyphHeight);
+    mt19937 rng(1234);
+    vector<string> strings = makeHudStrings(runsPerFrame, rng);
+    uniform_int_distribution<int> xDist(-40, width), yDist(-20, height);
+
+    vector<TextRun> runs;
+    size_t glyphCount = 0;
+    for (auto& s : strings) {
+        runs.push_back({xDist(rng), yDist(rng), s.c_str(), 0xFFFFFFFF});
+        glyphCount += s.size();
+    }
+
+    vector<uint32_t> fbRef((size_t)width * height, 0xFF000000);
+    vector<uint32_t> fbBatched((size_t)width * height, 0xFF000000);
+    vector<uint32_t> fbPattern((size_t)width * height, 0xFF000000);
+    Surface32 ref = {fbRef.data(), width, height, width};
+    Surface32 batched = {fbBatched.data(), width, height, width};
+    Surface32 pattern = {fbPattern.data(), width, height, width};
+
+    auto start = high_resolution_clock::now();
+    for (int f = 0; f < frames; ++f) {
+        for (auto& run : runs) drawTextPatternChapter1(pattern, run.text, run.x, run.y, run.color);
+    }
+    double patternSec = duration<double>(high_resolution_clock::now() - start).count();
+
+    start = high_resolution_clock::now();
+    for (int f = 0; f < frames; ++f) {
+        drawTextRunsReference(ref, runs.data(), runs.size(), atlas);
+    }
+    double refSec = duration<double>(high_resolution_clock::now() - start).count();
+
+    start = high_resolution_clock::now();
+    for (int f = 0; f < frames; ++f) {
+        drawTextRuns(batched, runs.data(), runs.size(), atlas);
+    }
+    double batchedSec = duration<double>(high_resolution_clock::now() - start).count();
+
+    double glyphs = (double)glyphCount * frames / 1e6;
+    cout << "\n=== 8x" << glyphHeight << " glyphs, " << runsPerFrame << " runs/frame on "
+         << width << "x" << height << " ===" << endl;
+    cout << fixed << setprecision(2);
+    cout << "Chapter 1 pattern, per-pixel checks: " << setw(8) << glyphs / patternSec << " Mglyphs/s" << endl;
+    cout << "Atlas, per-pixel bounds checks:      " << setw(8) << glyphs / refSec << " Mglyphs/s" << endl;
+    cout << "Atlas, batched runs + masked stores: " << setw(8) << glyphs / batchedSec << " Mglyphs/s ("
+         << refSec / batchedSec << "x vs per-pixel)" << endl;
+    cout << "Glyphs per 16.6 ms frame budget:     " << setw(8) << setprecision(0)
+         << (double)glyphCount * frames / batchedSec * 0.0166 << endl;
+    cout << "Batched output matches reference: " << (fbRef == fbBatched ? "✓ PASSED" : "✗ FAILED") << endl;
+}
+
+int main(int argc, char** args) {
+    cout << "=== Chapter 6: Glyph Atlas and Batched Text Renderer ===" << endl;
+    cout << "Glyph row store: ";
+#ifdef __AVX2__
+    cout << "AVX2 _mm256_maskstore_epi32" << endl;
+#else
+    cout << "scalar set-bit walk (compile with -march=native for AVX2)" << endl;
+#endif
+
+    cout << "\n8x8 atlas preview:" << endl;
+    GlyphAtlas atlas8(8);
+    printGlyphPreview(atlas8, "HUD 60fps");
+
+    runBenchmark(1920, 1080, 8);
+    runBenchmark(1920, 1080, 16);
+
+    return 0;
+}
@@ -0,0 +1,481 @@
+//Chapter 7: Sprites - Rotated and Affine-Transformed Sprite Blitter
+//Standard C++ libraries
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include <random>
+#include <cstdint>
+#include <cmath>
+#include <algorithm>
+
+//SIMD intrinsics
+#include <immintrin.h>  // SSE2 span kernels (scalar fallback)
+
+using namespace std;
+using namespace std::chrono;
+
+// ARGB8888 target holding premultiplied pixels, pitch in pixels
+struct SpriteSurface {
+    uint32_t* pixels;
+    int width;
+    int height;
+    int pitch;
+};
+
+// Sprite space to screen space:
+//     X = a*u + b*v + tx
+//     Y = c*u + d*v + ty
+// The sprite covers [0, w] x [0, h] in sprite space; pixel (i, j) is the unit square at (i, j).
+struct Affine2x3 {
+    double a = 1, b = 0, c = 0, d = 1, tx = 0, ty = 0;
+
+    // Rotate by angle and scale about sprite point (pivotU, pivotV), which lands on screen (x, y)
+    static Affine2x3 rotateScale(double angle, double scaleX, double scaleY, double pivotU, double pivotV,
+                                 double x, double y) {
+        double cs = cos(angle), sn = sin(angle);
+        Affine2x3 m;
+        m.a = cs * scaleX; m.b = -sn * scaleY;
+        m.c = sn * scaleX; m.d = cs * scaleY;
+        m.tx = x - (m.a * pivotU + m.b * pivotV);
+        m.ty = y - (m.c * pivotU + m.d * pivotV);
+        return m;
+    }
+};
+
+enum class AffineFilter { Nearest, Bilinear };
+
+// Premultiplied sprite with a one-pixel transparent border. Bilinear taps
+// that hang off the sprite read the border, so edges come out antialiased
+// without clamping any coordinate.
+class AffineSprite {
+public:
+    AffineSprite(const uint32_t* straightArgb, int width, int height, int pitch)
+        : width(width), height(height), stride(width + 2), pixels((size_t)(width + 2) * (height + 2), 0) {
+        for (int y = 0; y < height; ++y) {
+            for (int x = 0; x < width; ++x) pixels[(size_t)(y + 1) * stride + x + 1] = premultiply(straightArgb[(size_t)y * pitch + x]);
+        }
+    }
+
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+    // Pixel (x, y) for x in [-1, width], y in [-1, height]
+    const uint32_t* at(int x, int y) const { return pixels.data() + (size_t)(y + 1) * stride + (x + 1); }
+    int getStride() const { return stride; }
+
+private:
+    static uint32_t premultiply(uint32_t argb) {
+        uint32_t a = argb >> 24, out = a << 24;
+        for (int shift = 0; shift < 24; shift += 8) {
+            uint32_t x = ((argb >> shift) & 0xFF) * a + 128;
+            out |= ((x + (x >> 8)) >> 8) << shift;
+        }
+        return out;
+    }
+
+    int width, height, stride;
+    vector<uint32_t> pixels;
+};
+
+// ---------------------------------------------------------------------------
+// Span setup
+//
+// The inverse matrix is converted to 16.16 once. Sprite coordinates at screen
+// pixel center (x + 0.5, y + 0.5) are then exactly
+//     u = rowU(y) + x * du,  v = rowV(y) + x * dv
+// and each row's valid run of x is solved from that same integer formula, so
+// the inner loop needs no inside test and never reads outside the sprite.
+// ---------------------------------------------------------------------------
+
+static inline int64_t floorDiv(int64_t a, int64_t b) {
+    int64_t q = a / b;
+    return (a % b != 0 && ((a < 0) != (b < 0))) ? q - 1 : q;
+}
+static inline int64_t ceilDiv(int64_t a, int64_t b) { return -floorDiv(-a, b); }
+
+// Narrows [k0, k1] to the k with lo <= start + k * step <= hi
+static inline void clampSteps(int64_t start, int64_t step, int64_t lo, int64_t hi, int64_t& k0, int64_t& k1) {
+    if (step == 0) {
+        if (start < lo || start > hi) k1 = k0 - 1;
+        return;
+    }
+    if (step < 0) {
+        start = -start; step = -step;
+        swap(lo, hi); lo = -lo; hi = -hi;
+    }
+    k0 = max(k0, ceilDiv(lo - start, step));
+    k1 = min(k1, floorDiv(hi - start, step));
+}
+
+struct AffineSetup {
+    int64_t du, dv;        // per screen column
+    int64_t duy, dvy;      // per screen row
+    int64_t u0, v0;        // at the center of screen pixel (0, 0)
+    int64_t uLo, uHi, vLo, vHi;  // valid sample range, inclusive
+    int yTop, yBottom;     // candidate rows, already clipped
+    bool empty;
+};
+
+static AffineSetup setupAffine(const SpriteSurface& dst, int w, int h, const Affine2x3& m, AffineFilter filter) {
+    AffineSetup s = {};
+    s.empty = true;
+    double det = m.a * m.d - m.b * m.c;
+    if (w <= 0 || h <= 0 || fabs(det) < 1e-12) return s;
+
+    // Inverse: screen to sprite
+    double ia = m.d / det, ib = -m.b / det, ic = -m.c / det, id = m.a / det;
+    double itx = -(ia * m.tx + ib * m.ty), ity = -(ic * m.tx + id * m.ty);
+    const double ONE = 65536.0;
+    s.du = llround(ia * ONE);
+    s.dv = llround(ic * ONE);
+    s.duy = llround(ib * ONE);
+    s.dvy = llround(id * ONE);
+    s.u0 = llround((ia * 0.5 + ib * 0.5 + itx) * ONE);
+    s.v0 = llround((ic * 0.5 + id * 0.5 + ity) * ONE);
+
+    // Nearest samples the pixel containing the point; bilinear reaches half a
+    // pixel further, into the transparent border
+    int64_t margin = filter == AffineFilter::Bilinear ? 0x8000 : 0;
+    s.uLo = -margin; s.uHi = ((int64_t)w << 16) + margin - 1;
+    s.vLo = -margin; s.vHi = ((int64_t)h << 16) + margin - 1;
+
+    // Rows spanned by the transformed sprite quad (one pixel of slack for the
+    // fixed-point rounding; rows with nothing to draw come out empty anyway)
+    double pad = margin ? 0.5 : 0.0;
+    double ys[4] = {m.c * -pad + m.d * -pad, m.c * (w + pad) + m.d * -pad,
+                    m.c * -pad + m.d * (h + pad), m.c * (w + pad) + m.d * (h + pad)};
+    double yMin = *min_element(ys, ys + 4) + m.ty, yMax = *max_element(ys, ys + 4) + m.ty;
+    if (!(yMax > -1e9 && yMin < 1e9)) return s;
+    s.yTop = (int)max<double>(floor(yMin) - 1, 0);
+    s.yBottom = (int)min<double>(ceil(yMax) + 1, dst.height - 1);
+    s.empty = s.yTop > s.yBottom;
+    return s;
+}
+
+// Visible run [x0, x1] of screen row y and its sprite coordinates at x0
+static inline bool rowSpan(const AffineSetup& s, int y, int dstWidth, int& x0, int& x1, int64_t& u, int64_t& v) {
+    int64_t rowU = s.u0 + y * s.duy, rowV = s.v0 + y * s.dvy;
+    int64_t k0 = 0, k1 = dstWidth - 1;
+    clampSteps(rowU, s.du, s.uLo, s.uHi, k0, k1);
+    clampSteps(rowV, s.dv, s.vLo, s.vHi, k0, k1);
+    if (k0 > k1) return false;
+    x0 = (int)k0;
+    x1 = (int)k1;
+    u = rowU + k0 * s.du;
+    v = rowV + k0 * s.dv;
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// Pixel kernels (premultiplied src-over)
+// ---------------------------------------------------------------------------
+
+static inline uint32_t div255(uint32_t x) {
+    x += 128;
+    return (x + (x >> 8)) >> 8;
+}
+
+static inline uint32_t over(uint32_t src, uint32_t dst) {
+    uint32_t a = src >> 24;
+    if (a == 255) return src;
+    if (a == 0) return dst;
+    uint32_t inv = 255 - a, out = 0;
+    for (int shift = 0; shift < 32; shift += 8) {
+        out |= (((src >> shift) & 0xFF) + div255(((dst >> shift) & 0xFF) * inv)) << shift;
+    }
+    return out;
+}
+
+static const int BILINEAR_BITS = 7;
+static const int BILINEAR_ONE = 1 << BILINEAR_BITS;
+
+// Bilinear sample at (u, v), both already shifted by half a pixel to tap space
+static inline uint32_t bilinearSample(const AffineSprite& sprite, int64_t u, int64_t v) {
+    int x0 = (int)(u >> 16), y0 = (int)(v >> 16);
+    uint32_t fx = (uint32_t)(u >> (16 - BILINEAR_BITS)) & (BILINEAR_ONE - 1);
+    uint32_t fy = (uint32_t)(v >> (16 - BILINEAR_BITS)) & (BILINEAR_ONE - 1);
+    const uint32_t* r0 = sprite.at(x0, y0);
+    const uint32_t* r1 = r0 + sprite.getStride();
+    uint32_t out = 0;
+    for (int shift = 0; shift < 32; shift += 8) {
+        uint32_t top = ((r0[0] >> shift) & 0xFF) * (BILINEAR_ONE - fx) + ((r0[1] >> shift) & 0xFF) * fx;
+        uint32_t bot = ((r1[0] >> shift) & 0xFF) * (BILINEAR_ONE - fx) + ((r1[1] >> shift) & 0xFF) * fx;
+        out |= ((top * (BILINEAR_ONE - fy) + bot * fy + (1u << (2 * BILINEAR_BITS - 1))) >> (2 * BILINEAR_BITS)) << shift;
+    }
+    return out;
+}
+
+static void nearestSpanScalar(uint32_t* out, int count, const AffineSprite& sprite,
+                              int64_t u, int64_t v, int64_t du, int64_t dv) {
+    const uint32_t* base = sprite.at(0, 0);
+    const int stride = sprite.getStride();
+    for (int i = 0; i < count; ++i, u += du, v += dv) out[i] = over(base[(v >> 16) * stride + (u >> 16)], out[i]);
+}
+
+static void bilinearSpanScalar(uint32_t* out, int count, const AffineSprite& sprite,
+                               int64_t u, int64_t v, int64_t du, int64_t dv) {
+    for (int i = 0; i < count; ++i, u += du, v += dv) out[i] = over(bilinearSample(sprite, u, v), out[i]);
+}
+
+#ifdef __SSE2__
+// One filtered pixel as four 32-bit channels. Both rows' tap pairs share one
+// register: bytes of (p00, p01) and (p10, p11) are interleaved into 16-bit
+// pairs and weighted horizontally by madd, then the two row sums are paired
+// and weighted vertically by a second madd.
+static inline __m128i bilinearPixelX1(const AffineSprite& sprite, int64_t u, int64_t v) {
+    int x0 = (int)(u >> 16), y0 = (int)(v >> 16);
+    uint32_t fx = (uint32_t)(u >> (16 - BILINEAR_BITS)) & (BILINEAR_ONE - 1);
+    uint32_t fy = (uint32_t)(v >> (16 - BILINEAR_BITS)) & (BILINEAR_ONE - 1);
+    const uint32_t* r0 = sprite.at(x0, y0);
+    const __m128i zero = _mm_setzero_si128();
+    __m128i q = _mm_unpacklo_epi64(_mm_loadl_epi64((const __m128i*)r0),
+                                   _mm_loadl_epi64((const __m128i*)(r0 + sprite.getStride())));
+    q = _mm_shuffle_epi32(q, _MM_SHUFFLE(3, 1, 2, 0));         // p00 p10 p01 p11
+    q = _mm_unpacklo_epi8(q, _mm_srli_si128(q, 8));            // (p00, p01) bytes, (p10, p11) bytes
+    const __m128i wx = _mm_set1_epi32((int)((fx << 16) | (BILINEAR_ONE - fx)));
+    __m128i top = _mm_madd_epi16(_mm_unpacklo_epi8(q, zero), wx);
+    __m128i bot = _mm_madd_epi16(_mm_unpackhi_epi8(q, zero), wx);
+    __m128i rows = _mm_packs_epi32(top, bot);
+    __m128i tb = _mm_unpacklo_epi16(rows, _mm_srli_si128(rows, 8));
+    __m128i c = _mm_madd_epi16(tb, _mm_set1_epi32((int)((fy << 16) | (BILINEAR_ONE - fy))));
+    return _mm_srai_epi32(_mm_add_epi32(c, _mm_set1_epi32(1 << (2 * BILINEAR_BITS - 1))), 2 * BILINEAR_BITS);
+}
+
+// Four nearest samples at a time; blocks that are fully opaque or fully
+// transparent (most of a typical sprite) are stored or skipped whole
+static void nearestSpanSSE2(uint32_t* out, int count, const AffineSprite& sprite,
+                            int64_t u, int64_t v, int64_t du, int64_t dv) {
+    const uint32_t* base = sprite.at(0, 0);
+    const int stride = sprite.getStride();
+    const __m128i zero = _mm_setzero_si128(), c255 = _mm_set1_epi16(255), c128 = _mm_set1_epi16(128);
+    const __m128i alphaMask = _mm_set1_epi32((int)0xFF000000);
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        uint32_t p0 = base[(v >> 16) * stride + (u >> 16)];
+        uint32_t p1 = base[((v + dv) >> 16) * stride + ((u + du) >> 16)];
+        uint32_t p2 = base[((v + 2 * dv) >> 16) * stride + ((u + 2 * du) >> 16)];
+        uint32_t p3 = base[((v + 3 * dv) >> 16) * stride + ((u + 3 * du) >> 16)];
+        u += 4 * du;
+        v += 4 * dv;
+        __m128i src = _mm_setr_epi32((int)p0, (int)p1, (int)p2, (int)p3);
+        __m128i alpha = _mm_and_si128(src, alphaMask);
+        int opaque = _mm_movemask_epi8(_mm_cmpeq_epi32(alpha, alphaMask));
+        if (opaque == 0xFFFF) {
+            _mm_storeu_si128((__m128i*)(out + i), src);
+            continue;
+        }
+        if (_mm_movemask_epi8(_mm_cmpeq_epi32(alpha, zero)) == 0xFFFF) continue;
+        __m128i d = _mm_loadu_si128((const __m128i*)(out + i));
+        __m128i halves[2];
+        for (int h = 0; h < 2; ++h) {
+            __m128i s16 = h ? _mm_unpackhi_epi8(src, zero) : _mm_unpacklo_epi8(src, zero);
+            __m128i d16 = h ? _mm_unpackhi_epi8(d, zero) : _mm_unpacklo_epi8(d, zero);
+            __m128i a = _mm_shufflehi_epi16(_mm_shufflelo_epi16(s16, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+            __m128i x = _mm_add_epi16(_mm_mullo_epi16(d16, _mm_sub_epi16(c255, a)), c128);
+            halves[h] = _mm_add_epi16(s16, _mm_srli_epi16(_mm_add_epi16(x, _mm_srli_epi16(x, 8)), 8));
+        }
+        _mm_storeu_si128((__m128i*)(out + i), _mm_packus_epi16(halves[0], halves[1]));
+    }
+    nearestSpanScalar(out + i, count - i, sprite, u, v, du, dv);
+}
+
+static void bilinearSpanSSE2(uint32_t* out, int count, const AffineSprite& sprite,
+                             int64_t u, int64_t v, int64_t du, int64_t dv) {
+    const __m128i zero = _mm_setzero_si128(), c255 = _mm_set1_epi16(255), c128 = _mm_set1_epi16(128);
+    int i = 0;
+    for (; i + 2 <= count; i += 2, u += 2 * du, v += 2 * dv) {
+        __m128i src = _mm_packs_epi32(bilinearPixelX1(sprite, u, v), bilinearPixelX1(sprite, u + du, v + dv));
+        // src-over: src + div255(dst * (255 - srcAlpha))
+        __m128i alpha = _mm_shufflehi_epi16(_mm_shufflelo_epi16(src, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+        __m128i d = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)(out + i)), zero);
+        __m128i x = _mm_add_epi16(_mm_mullo_epi16(d, _mm_sub_epi16(c255, alpha)), c128);
+        x = _mm_srli_epi16(_mm_add_epi16(x, _mm_srli_epi16(x, 8)), 8);
+        _mm_storel_epi64((__m128i*)(out + i), _mm_packus_epi16(_mm_add_epi16(src, x), zero));
+    }
+    bilinearSpanScalar(out + i, count - i, sprite, u, v, du, dv);
+}
+#endif
+
+// ---------------------------------------------------------------------------
+// Affine blit
+// ---------------------------------------------------------------------------
+
+// Draws sprite through m (sprite space to screen space), premultiplied src-over.
+// Returns the number of screen pixels sampled.
+size_t blitAffine(const SpriteSurface& dst, const AffineSprite& sprite, const Affine2x3& m,
+                  AffineFilter filter, bool simd = true) {
+    AffineSetup s = setupAffine(dst, sprite.getWidth(), sprite.getHeight(), m, filter);
+    if (s.empty) return 0;
+    size_t sampled = 0;
+    for (int y = s.yTop; y <= s.yBottom; ++y) {
+        int x0, x1;
+        int64_t u, v;
+        if (!rowSpan(s, y, dst.width, x0, x1, u, v)) continue;
+        uint32_t* out = dst.pixels + (size_t)y * dst.pitch + x0;
+        int count = x1 - x0 + 1;
+        sampled += count;
+        if (filter == AffineFilter::Nearest) {
+#ifdef __SSE2__
+            if (simd) {
+                nearestSpanSSE2(out, count, sprite, u, v, s.du, s.dv);
+                continue;
+            }
+#endif
+            nearestSpanScalar(out, count, sprite, u, v, s.du, s.dv);
+            continue;
+        }
+        // Tap space: the left/top tap of the 2x2 footprint
+        u -= 0x8000;
+        v -= 0x8000;
+#ifdef __SSE2__
+        if (simd) {
+            bilinearSpanSSE2(out, count, sprite, u, v, s.du, s.dv);
+            continue;
+        }
+#endif
+        bilinearSpanScalar(out, count, sprite, u, v, s.du, s.dv);
+    }
+    return sampled;
+}
+
+// ---------------------------------------------------------------------------
+// Verification and benchmark
+// ---------------------------------------------------------------------------
+
+// Per-pixel reference: every screen pixel, inside test on the same 16.16 coordinates
+void blitAffineReference(const SpriteSurface& dst, const AffineSprite& sprite, const Affine2x3& m, AffineFilter filter) {
+    AffineSetup s = setupAffine(dst, sprite.getWidth(), sprite.getHeight(), m, filter);
+    double det = m.a * m.d - m.b * m.c;
+    if (fabs(det) < 1e-12) return;
+    for (int y = 0; y < dst.height; ++y) {
+        for (int x = 0; x < dst.width; ++x) {
+            int64_t u = s.u0 + y * s.duy + x * s.du, v = s.v0 + y * s.dvy + x * s.dv;
+            if (u < s.uLo || u > s.uHi || v < s.vLo || v > s.vHi) continue;
+            uint32_t& out = dst.pixels[(size_t)y * dst.pitch + x];
+            uint32_t sample = filter == AffineFilter::Nearest ? *sprite.at((int)(u >> 16), (int)(v >> 16))
+                                                              : bilinearSample(sprite, u - 0x8000, v - 0x8000);
+            out = over(sample, out);
+        }
+    }
+}
+
+// The straightforward approach: bounding box of the quad, float inverse per
+// pixel, inside test per pixel
+void blitAffineNaive(const SpriteSurface& dst, const vector<uint32_t>& premultiplied, int w, int h, const Affine2x3& m) {
+    double det = m.a * m.d - m.b * m.c;
+    double ia = m.d / det, ib = -m.b / det, ic = -m.c / det, id = m.a / det;
+    double xs[4] = {0, m.a * w, m.b * h, m.a * w + m.b * h}, ys[4] = {0, m.c * w, m.d * h, m.c * w + m.d * h};
+    int x0 = max(0, (int)floor(*min_element(xs, xs + 4) + m.tx)), x1 = min(dst.width - 1, (int)ceil(*max_element(xs, xs + 4) + m.tx));
+    int y0 = max(0, (int)floor(*min_element(ys, ys + 4) + m.ty)), y1 = min(dst.height - 1, (int)ceil(*max_element(ys, ys + 4) + m.ty));
+    for (int y = y0; y <= y1; ++y) {
+        for (int x = x0; x <= x1; ++x) {
+            double px = x + 0.5 - m.tx, py = y + 0.5 - m.ty;
+            double u = ia * px + ib * py, v = ic * px + id * py;
+            if (u >= 0 && u < w && v >= 0 && v < h) {
+                uint32_t& out = dst.pixels[(size_t)y * dst.pitch + x];
+                out = over(premultiplied[(size_t)(int)v * w + (int)u], out);
+            }
+        }
+    }
+}
+
+struct Image {
+    vector<uint32_t> pixels;
+    SpriteSurface surface;
+    Image(int w, int h, int pad) : pixels((size_t)(w + pad) * h, 0) { surface = {pixels.data(), w, h, w + pad}; }
+};
+
+// Round badge with a soft antialiased rim on a transparent background
+vector<uint32_t> makeSpritePixels(int w, int h, mt19937& rng) {
+    vector<uint32_t> px((size_t)w * h);
+    uint32_t color = rng() & 0xFFFFFF;
+    double r = min(w, h) * 0.5;
+    for (int y = 0; y < h; ++y) {
+        for (int x = 0; x < w; ++x) {
+            double d = hypot(x + 0.5 - w * 0.5, y + 0.5 - h * 0.5);
+            uint32_t a = d < r - 1 ? 255 : d < r ? (uint32_t)((r - d) * 255) : 0;
+            px[(size_t)y * w + x] = (a << 24) | (((x * 7) ^ (y * 5)) & 0xFF) << 16 | color;
+        }
+    }
+    return px;
+}
+
+bool verifyAffine() {
+    mt19937 rng(19);
+    uniform_real_distribution<double> unit(-1.0, 1.0);
+    Image ref(71, 53, 3), out(71, 53, 3);
+    for (int trial = 0; trial < 300; ++trial) {
+        int w = 1 + rng() % 30, h = 1 + rng() % 30;
+        vector<uint32_t> px(w * h);
+        for (auto& p : px) p = rng();
+        AffineSprite sprite(px.data(), w, h, w);
+
+        Affine2x3 m;
+        if (trial % 5 == 0) {
+            m = Affine2x3::rotateScale(unit(rng) * M_PI, 0.3 + 2 * fabs(unit(rng)), 0.3 + 2 * fabs(unit(rng)),
+                                       w * 0.5, h * 0.5, unit(rng) * 60 + 35, unit(rng) * 45 + 26);
+        } else {
+            // General affine: shear, mirroring and arbitrary translation
+            m.a = unit(rng) * 3; m.b = unit(rng) * 3; m.c = unit(rng) * 3; m.d = unit(rng) * 3;
+            m.tx = unit(rng) * 80 + 35; m.ty = unit(rng) * 60 + 26;
+        }
+        if (trial == 1) m = Affine2x3{};  // identity
+        for (AffineFilter filter : {AffineFilter::Nearest, AffineFilter::Bilinear}) {
+            for (int simd = 0; simd < 2; ++simd) {
+                for (size_t i = 0; i < ref.pixels.size(); ++i) ref.pixels[i] = out.pixels[i] = 0xFF000000u | (uint32_t)(i * 2654435761u);
+                blitAffineReference(ref.surface, sprite, m, filter);
+                blitAffine(out.surface, sprite, m, filter, simd != 0);
+                if (ref.pixels != out.pixels) {
+                    cout << "  mismatch: " << w << "x" << h << (filter == AffineFilter::Nearest ? " nearest" : " bilinear")
+                         << (simd ? " SIMD" : " scalar") << ", trial " << trial << endl;
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+template <typename Fn>
+double timeMs(int iterations, Fn fn) {
+    auto start = high_resolution_clock::now();
+    for (int i = 0; i < iterations; ++i) fn();
+    return duration<double, milli>(high_resolution_clock::now() - start).count() / iterations;
+}
+
+int main(int argc, char** args) {
+    cout << "=== Chapter 7: Rotated and Affine-Transformed Sprites ===" << endl;
+    cout << "Exact per-row spans vs per-pixel inside test (rotate, scale, shear, mirror, clipped): "
+         << (verifyAffine() ? "✓ PASSED" : "✗ FAILED") << endl;
+
+    Image screen(1920, 1080, 0);
+    mt19937 rng(4);
+    uniform_real_distribution<double> unit(0.0, 1.0);
+
+    cout << "\n=== 1000 rotating sprites per frame at 1920x1080 (ms per frame) ===" << endl;
+    cout << left << setw(8) << "Sprite" << right << setw(12) << "bbox+float" << setw(10) << "nearest"
+         << setw(12) << "bilinear" << setw(12) << "bil. SIMD" << setw(10) << "speedup" << endl;
+    for (int size : {32, 64, 128}) {
+        vector<uint32_t> px = makeSpritePixels(size, size, rng);
+        AffineSprite sprite(px.data(), size, size, size);
+        vector<uint32_t> premultiplied((size_t)size * size);
+        for (int y = 0; y < size; ++y)
+            for (int x = 0; x < size; ++x) premultiplied[(size_t)y * size + x] = *sprite.at(x, y);
+
+        vector<Affine2x3> frame(1000);
+        for (auto& m : frame) {
+            double scale = 0.6 + unit(rng) * 0.8;
+            m = Affine2x3::rotateScale(unit(rng) * 2 * M_PI, scale, scale, size * 0.5, size * 0.5,
+                                       unit(rng) * 2020 - 50, unit(rng) * 1180 - 50);
+        }
+        double naive = timeMs(3, [&] { for (auto& m : frame) blitAffineNaive(screen.surface, premultiplied, size, size, m); });
+        double nearest = timeMs(3, [&] { for (auto& m : frame) blitAffine(screen.surface, sprite, m, AffineFilter::Nearest); });
+        double bilinear = timeMs(3, [&] { for (auto& m : frame) blitAffine(screen.surface, sprite, m, AffineFilter::Bilinear, false); });
+        double simd = timeMs(3, [&] { for (auto& m : frame) blitAffine(screen.surface, sprite, m, AffineFilter::Bilinear, true); });
+        string name = to_string(size) + "x" + to_string(size);
+        cout << left << setw(8) << name << right << fixed << setprecision(2) << setw(12) << naive << setw(10)
+             << nearest << setw(12) << bilinear << setw(12) << simd << setw(9) << setprecision(1) << naive / nearest << "x" << endl;
+    }
+    cout << "(speedup is nearest vs the bounding-box loop)" << endl;
+    return 0;
+}
@@ -0,0 +1,394 @@
+//Chapter 7: Animation - Dirty-Rectangle Tracking and Partial Present
+//Standard C++ libraries
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include <random>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+
+using namespace std;
+using namespace std::chrono;
+
+// ARGB8888 framebuffer, pitch in pixels
+struct FrameSurface {
+    uint32_t* pixels;
+    int width;
+    int height;
+    int pitch;
+};
+
+// Half-open pixel rectangle [x, x + w) x [y, y + h); same layout as SDL_Rect,
+// so a dirty list can be handed to SDL_UpdateWindowSurfaceRects as is
+struct DirtyRect {
+    int x, y, w, h;
+
+    bool empty() const { return w <= 0 || h <= 0; }
+    int64_t area() const { return empty() ? 0 : (int64_t)w * h; }
+    int right() const { return x + w; }
+    int bottom() const { return y + h; }
+};
+
+static inline DirtyRect unionRect(const DirtyRect& a, const DirtyRect& b) {
+    int x0 = min(a.x, b.x), y0 = min(a.y, b.y);
+    return {x0, y0, max(a.right(), b.right()) - x0, max(a.bottom(), b.bottom()) - y0};
+}
+
+static inline DirtyRect intersectRect(const DirtyRect& a, const DirtyRect& b) {
+    int x0 = max(a.x, b.x), y0 = max(a.y, b.y);
+    return {x0, y0, min(a.right(), b.right()) - x0, min(a.bottom(), b.bottom()) - y0};
+}
+
+// Damaged screen area for one frame, kept as a short list of disjoint
+// rectangles. Overlapping damage is merged, nearby damage is merged when the
+// union wastes little area, and the list never grows past maxRects: past that
+// the cheapest pair is merged. When the damage covers most of the screen it
+// collapses to one full-screen rectangle, since per-rect overhead would then
+// cost more than it saves.
+class DirtyRegion {
+public:
+    DirtyRegion(int screenWidth, int screenHeight, size_t maxRects = 16, double fullScreenFraction = 0.5)
+        : screen{0, 0, screenWidth, screenHeight}, maxRects(maxRects),
+          fullScreenArea((int64_t)(screen.area() * fullScreenFraction)) {}
+
+    void add(DirtyRect r) {
+        r = intersectRect(r, screen);
+        if (r.empty() || isFullScreen()) return;
+        insert(r);
+        while (rects.size() > maxRects) mergeCheapestPair();
+        int64_t total = 0;
+        for (const DirtyRect& d : rects) total += d.area();
+        if (total >= fullScreenArea) markFullScreen();
+    }
+
+    void markFullScreen() { rects.assign(1, screen); }
+    bool isFullScreen() const { return rects.size() == 1 && rects[0].area() == screen.area(); }
+    void clear() { rects.clear(); }
+    bool empty() const { return rects.empty(); }
+
+    const vector<DirtyRect>& getRects() const { return rects; }
+    int64_t area() const {
+        int64_t total = 0;
+        for (const DirtyRect& d : rects) total += d.area();
+        return total;
+    }
+
+private:
+    // Area a union would cover that neither rectangle needs
+    static int64_t waste(const DirtyRect& a, const DirtyRect& b) {
+        return unionRect(a, b).area() - a.area() - b.area() + max<int64_t>(intersectRect(a, b).area(), 0);
+    }
+
+    // Merges r with anything it overlaps or sits cheaply next to, repeating
+    // while the grown rectangle picks up more neighbours. Keeps the list disjoint.
+    void insert(DirtyRect r) {
+        for (size_t i = 0; i < rects.size();) {
+            const DirtyRect& e = rects[i];
+            bool overlaps = !intersectRect(r, e).empty();
+            if (overlaps || waste(r, e) <= (r.area() + e.area()) / 4) {
+                r = unionRect(r, e);
+                rects[i] = rects.back();
+                rects.pop_back();
+                i = 0;
+                continue;
+            }
+            ++i;
+        }
+        rects.push_back(r);
+    }
+
+    void mergeCheapestPair() {
+        size_t bestA = 0, bestB = 1;
+        int64_t best = INT64_MAX;
+        for (size_t a = 0; a < rects.size(); ++a) {
+            for (size_t b = a + 1; b < rects.size(); ++b) {
+                int64_t w = waste(rects[a], rects[b]);
+                if (w < best) { best = w; bestA = a; bestB = b; }
+            }
+        }
+        DirtyRect merged = unionRect(rects[bestA], rects[bestB]);
+        rects.erase(rects.begin() + bestB);
+        rects.erase(rects.begin() + bestA);
+        insert(merged);
+    }
+
+    DirtyRect screen;
+    size_t maxRects;
+    int64_t fullScreenArea;
+    vector<DirtyRect> rects;
+};
+
+// ---------------------------------------------------------------------------
+// Scene: every draw call takes a clip rectangle, so the same code serves full
+// redraws (clip = screen) and region redraws (clip = one dirty rect)
+// ---------------------------------------------------------------------------
+
+static inline uint32_t backgroundPixel(int x, int y) {
+    if ((x & 63) == 0 || (y & 63) == 0) return 0xFF303848;
+    uint32_t shade = 0x20 + (uint32_t)y * 0x40 / 1080;
+    return 0xFF000000u | (shade / 2 << 16) | (shade << 8) | (shade + 0x20);
+}
+
+void drawBackground(const FrameSurface& s, const DirtyRect& clip) {
+    for (int y = clip.y; y < clip.bottom(); ++y) {
+        uint32_t* row = s.pixels + (size_t)y * s.pitch;
+        for (int x = clip.x; x < clip.right(); ++x) row[x] = backgroundPixel(x, y);
+    }
+}
+
+struct SceneObject {
+    DirtyRect bounds;
+    uint32_t color;
+    bool round;
+};
+
+void drawObject(const FrameSurface& s, const SceneObject& o, const DirtyRect& clip) {
+    DirtyRect r = intersectRect(o.bounds, clip);
+    if (r.empty()) return;
+    double cx = o.bounds.x + o.bounds.w * 0.5, cy = o.bounds.y + o.bounds.h * 0.5;
+    double rx = o.bounds.w * 0.5, ry = o.bounds.h * 0.5;
+    for (int y = r.y; y < r.bottom(); ++y) {
+        uint32_t* row = s.pixels + (size_t)y * s.pitch;
+        if (!o.round) {
+            fill(row + r.x, row + r.right(), o.color);
+            continue;
+        }
+        // Ellipse span on this row, intersected with the clip
+        double dy = (y + 0.5 - cy) / ry;
+        if (dy * dy >= 1) continue;
+        double half = rx * sqrt(1 - dy * dy);
+        int x0 = max(r.x, (int)ceil(cx - half - 0.5)), x1 = min(r.right(), (int)ceil(cx + half - 0.5));
+        if (x0 < x1) fill(row + x0, row + x1, o.color);
+    }
+}
+
+// Kiosk screen: static panels, plus a clock, a scrolling ticker, a spinner
+// and a progress bar that change a little every frame
+class KioskScene {
+public:
+    explicit KioskScene(int width, int height) : width(width), height(height) {
+        for (int i = 0; i < 6; ++i) {
+            int pw = width * 27 / 100, ph = height / 3;
+            objects.push_back({{width / 24 + (i % 3) * (width * 5 / 16), height / 9 + (i / 3) * (height * 7 / 18), pw, ph},
+                               0xFF1C2430u + (uint32_t)i * 0x030303, false});
+        }
+        clock = objects.size();
+        objects.push_back({{width - 260, 20, 220, 64}, 0xFF405080, false});
+        ticker = objects.size();
+        for (int i = 0; i < 12; ++i) objects.push_back({{i * 170, height - 56, 120, 28}, 0xFFE0C040, false});
+        spinner = objects.size();
+        objects.push_back({{0, 0, 36, 36}, 0xFF40E080, true});
+        progress = objects.size();
+        objects.push_back({{80, height - 100, 0, 14}, 0xFF3090F0, false});
+        update(0, nullptr);
+    }
+
+    // Advances one frame; each object that changes reports its old and new bounds
+    void update(int frame, DirtyRegion* damage) {
+        auto change = [&](size_t i, DirtyRect bounds, uint32_t color) {
+            SceneObject& o = objects[i];
+            if (o.bounds.x == bounds.x && o.bounds.y == bounds.y && o.bounds.w == bounds.w &&
+                o.bounds.h == bounds.h && o.color == color) return;
+            if (damage) { damage->add(o.bounds); damage->add(bounds); }
+            o.bounds = bounds;
+            o.color = color;
+        };
+        // Clock ticks once a second
+        uint32_t second = (uint32_t)(frame / 60);
+        change(clock, objects[clock].bounds, 0xFF405080u + (second % 8) * 0x0C0804);
+        // Ticker glyphs scroll two pixels a frame, wrapping around
+        for (int i = 0; i < 12; ++i) {
+            int x = ((i * 170 - frame * 2) % (12 * 170) + 12 * 170) % (12 * 170) - 170;
+            change(ticker + i, {x, height - 56, 120, 28}, 0xFFE0C040);
+        }
+        // Spinner circles the clock
+        double a = frame * 0.15;
+        change(spinner, {width - 150 + (int)lround(60 * cos(a)) - 18, 140 + (int)lround(30 * sin(a)) - 18, 36, 36}, 0xFF40E080);
+        // Progress bar grows one pixel every other frame
+        change(progress, {80, height - 100, (frame / 2) % (width - 160), 14}, 0xFF3090F0);
+    }
+
+    void draw(const FrameSurface& s, const DirtyRect& clip) const {
+        drawBackground(s, clip);
+        for (const SceneObject& o : objects) drawObject(s, o, clip);
+    }
+
+    // Everything moves: a busy screen, to show the full-screen fallback
+    void scramble(mt19937& rng, DirtyRegion* damage) {
+        for (size_t i = 0; i < clock; ++i) {
+            DirtyRect b = objects[i].bounds;
+            b.x = (int)(rng() % (width - b.w));
+            b.y = (int)(rng() % (height - b.h));
+            if (damage) { damage->add(objects[i].bounds); damage->add(b); }
+            objects[i].bounds = b;
+        }
+    }
+
+private:
+    int width, height;
+    vector<SceneObject> objects;
+    size_t clock, ticker, spinner, progress;
+};
+
+// ---------------------------------------------------------------------------
+// Present: the display copy stands in for the texture / window surface. Full
+// present uploads every row; partial present uploads only the dirty rects,
+// exactly what SDL_UpdateTexture(texture, &rect, pixels, pitch) per rect or
+// one SDL_UpdateWindowSurfaceRects(window, rects, count) call would move;
+// double_buffering.cpp --dirty makes that call in a live SDL loop.
+// ---------------------------------------------------------------------------
+
+size_t presentFull(const FrameSurface& display, const FrameSurface& frame) {
+    for (int y = 0; y < frame.height; ++y) {
+        memcpy(display.pixels + (size_t)y * display.pitch, frame.pixels + (size_t)y * frame.pitch, (size_t)frame.width * 4);
+    }
+    return (size_t)frame.width * frame.height * 4;
+}
+
+size_t presentRects(const FrameSurface& display, const FrameSurface& frame, const vector<DirtyRect>& rects) {
+    size_t bytes = 0;
+    for (const DirtyRect& r : rects) {
+        for (int y = r.y; y < r.bottom(); ++y) {
+            memcpy(display.pixels + (size_t)y * display.pitch + r.x, frame.pixels + (size_t)y * frame.pitch + r.x, (size_t)r.w * 4);
+        }
+        bytes += (size_t)r.area() * 4;
+    }
+    return bytes;
+}
+
+// Redraws only the damage, then presents only the damage. A static frame
+// (nothing dirty) does no work at all.
+size_t renderDirty(const FrameSurface& frame, const FrameSurface& display, const KioskScene& scene, DirtyRegion& damage) {
+    if (damage.empty()) return 0;
+    for (const DirtyRect& r : damage.getRects()) scene.draw(frame, r);
+    size_t bytes = presentRects(display, frame, damage.getRects());
+    damage.clear();
+    return bytes;
+}
+
+// ---------------------------------------------------------------------------
+// Verification and benchmark
+// ---------------------------------------------------------------------------
+
+struct Image {
+    vector<uint32_t> pixels;
+    FrameSurface surface;
+    Image(int w, int h, int pad) : pixels((size_t)(w + pad) * h, 0) { surface = {pixels.data(), w, h, w + pad}; }
+};
+
+bool verifyDirtyRegion() {
+    mt19937 rng(21);
+    const int W = 200, H = 150;
+    for (int trial = 0; trial < 2000; ++trial) {
+        DirtyRegion region(W, H, 1 + rng() % 12);
+        vector<uint8_t> needed(W * H, 0);
+        int n = 1 + rng() % 40;
+        for (int i = 0; i < n; ++i) {
+            DirtyRect r = {(int)(rng() % 260) - 30, (int)(rng() % 200) - 25, (int)(rng() % 40), (int)(rng() % 30)};
+            region.add(r);
+            DirtyRect c = intersectRect(r, {0, 0, W, H});
+            for (int y = c.y; y < c.bottom(); ++y)
+                for (int x = c.x; x < c.right(); ++x) needed[y * W + x] = 1;
+        }
+        // Every damaged pixel covered exactly once, list bounded and on screen
+        vector<uint8_t> covered(W * H, 0);
+        for (const DirtyRect& r : region.getRects()) {
+            if (r.x < 0 || r.y < 0 || r.right() > W || r.bottom() > H || r.empty()) return false;
+            for (int y = r.y; y < r.bottom(); ++y)
+                for (int x = r.x; x < r.right(); ++x) if (covered[y * W + x]++) return false;
+        }
+        for (int i = 0; i < W * H; ++i) if (needed[i] && !covered[i]) return false;
+    }
+    return true;
+}
+
+// Dirty rendering must leave the display identical to full redraws, frame by frame
+bool verifyPartialPresent() {
+    const int W = 640, H = 360;
+    Image fullFrame(W, H, 0), fullDisplay(W, H, 0), dirtyFrame(W, H, 5), dirtyDisplay(W, H, 3);
+    KioskScene fullScene(W, H), dirtyScene(W, H);
+    DirtyRegion damage(W, H);
+    mt19937 rngA(5), rngB(5);
+    damage.markFullScreen();
+    for (int frame = 0; frame < 400; ++frame) {
+        fullScene.update(frame, nullptr);
+        dirtyScene.update(frame, &damage);
+        if (frame % 97 == 50) { fullScene.scramble(rngA, nullptr); dirtyScene.scramble(rngB, &damage); }
+        fullScene.draw(fullFrame.surface, {0, 0, W, H});
+        presentFull(fullDisplay.surface, fullFrame.surface);
+        renderDirty(dirtyFrame.surface, dirtyDisplay.surface, dirtyScene, damage);
+        for (int y = 0; y < H; ++y) {
+            if (memcmp(fullDisplay.pixels.data() + (size_t)y * W, dirtyDisplay.pixels.data() + (size_t)y * (W + 3), W * 4) != 0) {
+                cout << "  display mismatch at frame " << frame << ", row " << y << endl;
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+int main(int argc, char** args) {
+    cout << "=== Chapter 7: Dirty-Rectangle Tracking and Partial Present ===" << endl;
+    cout << "Region list: covers all damage, disjoint, bounded: " << (verifyDirtyRegion() ? "✓ PASSED" : "✗ FAILED") << endl;
+    cout << "Dirty redraw + partial present matches full redraw every frame: "
+         << (verifyPartialPresent() ? "✓ PASSED" : "✗ FAILED") << endl;
+
+    const int W = 1920, H = 1080, FRAMES = 300;
+    Image frame(W, H, 0), display(W, H, 0);
+    KioskScene scene(W, H);
+    DirtyRegion damage(W, H);
+    double screenBytes = (double)W * H * 4;
+
+    // Full redraw and full present every frame, as the demo loops do
+    auto start = high_resolution_clock::now();
+    for (int f = 0; f < FRAMES; ++f) {
+        scene.update(f, nullptr);
+        scene.draw(frame.surface, {0, 0, W, H});
+        presentFull(display.surface, frame.surface);
+    }
+    double fullMs = duration<double, milli>(high_resolution_clock::now() - start).count() / FRAMES;
+
+    // Dirty rectangles: same animation, same final image
+    damage.markFullScreen();
+    renderDirty(frame.surface, display.surface, scene, damage);
+    double uploaded = 0, dirtyArea = 0, rectCount = 0;
+    start = high_resolution_clock::now();
+    for (int f = 0; f < FRAMES; ++f) {
+        scene.update(f, &damage);
+        dirtyArea += damage.area();
+        rectCount += damage.getRects().size();
+        uploaded += renderDirty(frame.surface, display.surface, scene, damage);
+    }
+    double dirtyMs = duration<double, milli>(high_resolution_clock::now() - start).count() / FRAMES;
+
+    // Static frames: nothing changed, nothing to do
+    start = high_resolution_clock::now();
+    for (int f = 0; f < FRAMES; ++f) renderDirty(frame.surface, display.surface, scene, damage);
+    double staticMs = duration<double, milli>(high_resolution_clock::now() - start).count() / FRAMES;
+
+    // Busy frame: everything moved, the region collapses to one full-screen rect
+    mt19937 rng(6);
+    scene.scramble(rng, &damage);
+    bool collapsed = damage.isFullScreen();
+    start = high_resolution_clock::now();
+    renderDirty(frame.surface, display.surface, scene, damage);
+    double busyMs = duration<double, milli>(high_resolution_clock::now() - start).count();
+
+    cout << "\n=== 1920x1080 kiosk screen, " << FRAMES << " frames (per frame) ===" << endl;
+    cout << fixed << setprecision(3);
+    cout << "Full redraw + present:     " << setw(8) << fullMs << " ms, " << setprecision(1) << screenBytes / 1048576
+         << " MB uploaded" << endl;
+    cout << setprecision(3);
+    cout << "Dirty rects:               " << setw(8) << dirtyMs << " ms, " << setprecision(2)
+         << uploaded / FRAMES / 1048576 << " MB uploaded, " << setprecision(1) << rectCount / FRAMES << " rects, "
+         << setprecision(2) << 100.0 * dirtyArea / FRAMES / ((double)W * H) << "% of screen  ("
+         << setprecision(1) << fullMs / dirtyMs << "x)" << endl;
+    cout << setprecision(4);
+    cout << "Static frame:              " << setw(8) << staticMs << " ms" << endl;
+    cout << setprecision(3);
+    cout << "Busy frame (" << (collapsed ? "collapsed to full screen" : "not collapsed") << "): " << setw(8) << busyMs << " ms" << endl;
+    return 0;
+}
@@ -4,6 +4,12 @@
 #include <iostream>
 #include <chrono>
 #include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <algorithm>
 
 //SDL3 library
 
@@ -12,6 +18,8 @@
 
 using namespace std;
 
+// Book's DoubleBuffer: draws into an off-screen surface, then copies all of
+// it into the window surface on every swap
 class DoubleBuffer {
 private:
     SDL_Surface* frontBuffer;
@@ -39,6 +47,11 @@ public:
     SDL_Surface* getBackBuffer() {
         return backBuffer;
     }
+
+    // Frame data the CPU copies on each swap
+    size_t bytesCopiedPerSwap() const {
+        return backBuffer ? (size_t)backBuffer->pitch * backBuffer->h : 0;
+    }
     
     void swap() {
         // Copy back buffer to front buffer
@@ -60,6 +73,317 @@ public:
     }
 };
 
+// Where frames are drawn and how they reach the screen
+enum class PresentPath {
+    CopyToWindow,       // book's DoubleBuffer: back buffer blitted into the window surface
+    WindowSurface,      // draw straight into the window surface, then update it
+    StreamingTextures,  // draw straight into a locked streaming texture, rotating 2 or 3 of them
+    DirtyRects          // window surface kept between frames: redraw and update only what moved
+};
+
+// Zero-copy presenter. The frame is drawn in the memory that gets displayed:
+// either the window surface or a locked streaming texture exposed as an
+// SDL_Surface, so no back buffer is ever copied on the CPU. With textures it
+// rotates among two or three, so the one just submitted can still be in use
+// by the renderer while the next frame is drawn into a different one; the
+// only copy left is the upload SDL_UnlockTexture does. If the renderer or a
+// texture cannot be created, it falls back to the window surface.
+class PageFlipPresenter {
+private:
+    SDL_Window* window;
+    SDL_Renderer* renderer;
+    vector<SDL_Texture*> textures;
+    size_t current;
+    SDL_Surface* target;
+    PresentPath path;
+    int width, height;
+    size_t uploadBytes;  // texture data uploaded by the last present
+
+    void destroyTextures() {
+        for (SDL_Texture* texture : textures) SDL_DestroyTexture(texture);
+        textures.clear();
+    }
+
+    // (Re)creates the rotation at the window's pixel size
+    bool createTextures(int count) {
+        destroyTextures();
+        SDL_GetWindowSizeInPixels(window, &width, &height);
+        for (int i = 0; i < count; ++i) {
+            SDL_Texture* texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888,
+                                                     SDL_TEXTUREACCESS_STREAMING, width, height);
+            if (!texture) {
+                cout << "Error creating streaming texture: " << SDL_GetError() << endl;
+                return false;
+            }
+            textures.push_back(texture);
+        }
+        current = 0;
+        return true;
+    }
+
+    // The window cannot have a surface while a renderer owns it, so the
+    // renderer goes too
+    void fallBackToWindowSurface() {
+        cout << "Falling back to drawing into the window surface" << endl;
+        destroyTextures();
+        if (renderer) {
+            SDL_DestroyRenderer(renderer);
+            renderer = nullptr;
+        }
+        path = PresentPath::WindowSurface;
+    }
+
+public:
+    PageFlipPresenter(SDL_Window* win, PresentPath presentPath, int bufferCount = 3)
+        : window(win), renderer(nullptr), current(0), target(nullptr), path(presentPath), width(0), height(0),
+          uploadBytes(0) {
+        if (path == PresentPath::StreamingTextures) {
+            renderer = SDL_CreateRenderer(window, NULL);
+            if (!renderer) {
+                cout << "Error creating renderer: " << SDL_GetError() << endl;
+                fallBackToWindowSurface();
+            } else if (!createTextures(max(2, min(bufferCount, 3)))) {
+                fallBackToWindowSurface();
+            }
+        }
+    }
+
+    ~PageFlipPresenter() {
+        destroyTextures();
+        if (renderer) {
+            SDL_DestroyRenderer(renderer);
+        }
+    }
+
+    PresentPath getPath() const { return path; }
+    int getBufferCount() const { return path == PresentPath::StreamingTextures ? (int)textures.size() : 1; }
+
+    // Frame data SDL_UnlockTexture uploaded in the last present (0 on the window surface)
+    size_t bytesUploadedPerFrame() const { return uploadBytes; }
+
+    // Surface to draw this frame into; its previous contents are undefined,
+    // so the whole frame must be redrawn. Returns NULL if nothing can be drawn.
+    SDL_Surface* beginFrame() {
+        if (path == PresentPath::WindowSurface) {
+            target = SDL_GetWindowSurface(window);  // follows window resizes
+            return target;
+        }
+        int w, h;
+        SDL_GetWindowSizeInPixels(window, &w, &h);
+        if ((w != width || h != height) && !createTextures((int)textures.size())) {
+            fallBackToWindowSurface();
+            return beginFrame();
+        }
+
+        if (!SDL_LockTextureToSurface(textures[current], NULL, &target)) {
+            cout << "Error locking texture: " << SDL_GetError() << endl;
+            target = NULL;
+        }
+        return target;
+    }
+
+    // Hands the drawn frame to the display and moves on to the next buffer
+    void present() {
+        uploadBytes = 0;
+        if (!target) return;
+        if (path == PresentPath::WindowSurface) {
+            SDL_UpdateWindowSurface(window);
+        } else {
+            uploadBytes = (size_t)target->pitch * target->h;
+            SDL_UnlockTexture(textures[current]);  // uploads the frame and releases the lock surface
+            SDL_RenderTexture(renderer, textures[current], NULL, NULL);
+            SDL_RenderPresent(renderer);
+            current = (current + 1) % textures.size();
+        }
+        target = NULL;
+    }
+};
+
+// Dirty-rectangle list from chapter7/dirty_rectangles.cpp, where the merge
+// policy is explained and benchmarked. Same layout as SDL_Rect.
+struct DirtyRect {
+    int x, y, w, h;
+
+    bool empty() const { return w <= 0 || h <= 0; }
+    int64_t area() const { return empty() ? 0 : (int64_t)w * h; }
+    int right() const { return x + w; }
+    int bottom() const { return y + h; }
+};
+static_assert(sizeof(DirtyRect) == sizeof(SDL_Rect), "DirtyRect is passed to SDL as SDL_Rect");
+
+static inline DirtyRect unionRect(const DirtyRect& a, const DirtyRect& b) {
+    int x0 = min(a.x, b.x), y0 = min(a.y, b.y);
+    return {x0, y0, max(a.right(), b.right()) - x0, max(a.bottom(), b.bottom()) - y0};
+}
+
+static inline DirtyRect intersectRect(const DirtyRect& a, const DirtyRect& b) {
+    int x0 = max(a.x, b.x), y0 = max(a.y, b.y);
+    return {x0, y0, min(a.right(), b.right()) - x0, min(a.bottom(), b.bottom()) - y0};
+}
+
+class DirtyRegion {
+public:
+    DirtyRegion(int screenWidth, int screenHeight, size_t maxRects = 16, double fullScreenFraction = 0.5)
+        : screen{0, 0, screenWidth, screenHeight}, maxRects(maxRects),
+          fullScreenArea((int64_t)(screen.area() * fullScreenFraction)) {}
+
+    void add(DirtyRect r) {
+        r = intersectRect(r, screen);
+        if (r.empty() || isFullScreen()) return;
+        insert(r);
+        while (rects.size() > maxRects) mergeCheapestPair();
+        if (area() >= fullScreenArea) markFullScreen();
+    }
+
+    void markFullScreen() { rects.assign(1, screen); }
+    bool isFullScreen() const { return rects.size() == 1 && rects[0].area() == screen.area(); }
+    void clear() { rects.clear(); }
+
+    const vector<DirtyRect>& getRects() const { return rects; }
+    int64_t area() const {
+        int64_t total = 0;
+        for (const DirtyRect& d : rects) total += d.area();
+        return total;
+    }
+
+private:
+    static int64_t waste(const DirtyRect& a, const DirtyRect& b) {
+        return unionRect(a, b).area() - a.area() - b.area() + max<int64_t>(intersectRect(a, b).area(), 0);
+    }
+
+    void insert(DirtyRect r) {
+        for (size_t i = 0; i < rects.size();) {
+            const DirtyRect& e = rects[i];
+            bool overlaps = !intersectRect(r, e).empty();
+            if (overlaps || waste(r, e) <= (r.area() + e.area()) / 4) {
+                r = unionRect(r, e);
+                rects[i] = rects.back();
+                rects.pop_back();
+                i = 0;
+                continue;
+            }
+            ++i;
+        }
+        rects.push_back(r);
+    }
+
+    void mergeCheapestPair() {
+        size_t bestA = 0, bestB = 1;
+        int64_t best = INT64_MAX;
+        for (size_t a = 0; a < rects.size(); ++a) {
+            for (size_t b = a + 1; b < rects.size(); ++b) {
+                int64_t w = waste(rects[a], rects[b]);
+                if (w < best) { best = w; bestA = a; bestB = b; }
+            }
+        }
+        DirtyRect merged = unionRect(rects[bestA], rects[bestB]);
+        rects.erase(rects.begin() + bestB);
+        rects.erase(rects.begin() + bestA);
+        insert(merged);
+    }
+
+    DirtyRect screen;
+    size_t maxRects;
+    int64_t fullScreenArea;
+    vector<DirtyRect> rects;
+};
+
+// Partial presenter. The window surface keeps its pixels between frames, so
+// only the places where something was or now is need clearing and redrawing,
+// and only those rectangles are handed to SDL_UpdateWindowSurfaceRects. A new
+// or resized surface has undefined contents and is redrawn in full.
+class DirtyRectPresenter {
+private:
+    SDL_Window* window;
+    SDL_Surface* target;
+    DirtyRegion region;
+    vector<DirtyRect> lastBounds;   // where the moving objects were drawn last frame
+    int width, height;
+
+public:
+    DirtyRectPresenter(SDL_Window* win) : window(win), target(nullptr), region(0, 0), width(-1), height(-1) {}
+
+    // Window surface with the damaged rectangles cleared to `background`,
+    // given the bounds the moving objects will be drawn at this frame
+    SDL_Surface* beginFrame(const vector<DirtyRect>& bounds, uint32_t background) {
+        target = SDL_GetWindowSurface(window);
+        if (!target) return NULL;
+        if (target->w != width || target->h != height) {
+            width = target->w;
+            height = target->h;
+            region = DirtyRegion(width, height);
+            region.markFullScreen();
+        }
+        for (const DirtyRect& r : lastBounds) region.add(r);
+        for (const DirtyRect& r : bounds) region.add(r);
+        lastBounds = bounds;
+
+        for (const DirtyRect& r : region.getRects()) {
+            SDL_FillSurfaceRect(target, (const SDL_Rect*)&r, background);
+        }
+        return target;
+    }
+
+    // Fraction of the window this frame redraws and updates
+    double dirtyFraction() const {
+        return width > 0 && height > 0 ? (double)region.area() / ((double)width * height) : 0.0;
+    }
+
+    void present() {
+        if (!target) return;
+        const vector<DirtyRect>& rects = region.getRects();
+        if (!rects.empty()) SDL_UpdateWindowSurfaceRects(window, (const SDL_Rect*)rects.data(), (int)rects.size());
+        region.clear();
+        target = NULL;
+    }
+};
+
+// Per-frame timing for whichever path is in use, averaged once a second
+struct FrameStats {
+    int frames = 0;
+    double renderMs = 0;      // clearing and drawing
+    double presentMs = 0;     // from the end of drawing until present returns
+    double latencyMs = 0;     // from the start of drawing until present returns
+    double bytesCopied = 0;   // frame data blitted on the CPU (back buffer into window surface)
+    double bytesUploaded = 0; // frame data uploaded by SDL_UnlockTexture; window-surface
+                              // updates are left to the video backend and not counted
+    double dirty = 0;         // fraction of the window redrawn and updated
+
+    void add(double render, double presentTime, size_t copied, size_t uploaded, double dirtyFraction = 1.0) {
+        ++frames;
+        renderMs += render;
+        presentMs += presentTime;
+        latencyMs += render + presentTime;
+        bytesCopied += copied;
+        bytesUploaded += uploaded;
+        dirty += dirtyFraction;
+    }
+
+    string summary() const {
+        char text[256];
+        double n = max(frames, 1);
+        snprintf(text, sizeof(text),
+                 "present %.2f ms | latency %.2f ms | CPU copy %.1f MB/frame | texture upload %.1f MB/frame | dirty %.1f%%",
+                 presentMs / n, latencyMs / n, bytesCopied / n / (1024.0 * 1024.0),
+                 bytesUploaded / n / (1024.0 * 1024.0), 100.0 * dirty / n);
+        return text;
+    }
+};
+
+static double elapsedMs(chrono::high_resolution_clock::time_point since) {
+    return chrono::duration<double, milli>(chrono::high_resolution_clock::now() - since).count();
+}
+
+// Whole-surface clear, row by row so any pitch works
+void clearSurface(SDL_Surface* surface, uint32_t color) {
+    SDL_LockSurface(surface);
+    for (int y = 0; y < surface->h; ++y) {
+        uint32_t* row = (uint32_t*)((uint8_t*)surface->pixels + (size_t)y * surface->pitch);
+        fill(row, row + surface->w, color);
+    }
+    SDL_UnlockSurface(surface);
+}
+
 void drawCircle(SDL_Surface* surface, int cx, int cy, int radius, uint32_t color) {
     SDL_LockSurface(surface);
     uint32_t* pixels = (uint32_t*)surface->pixels;
@@ -79,28 +403,35 @@ void drawCircle(SDL_Surface* surface, int cx, int cy, int radius, uint32_t color
     SDL_UnlockSurface(surface);
 }
 
+struct SceneCircle {
+    int x, y, radius;
+    uint32_t color;
+
+    DirtyRect bounds() const { return {x - radius, y - radius, 2 * radius + 1, 2 * radius + 1}; }
+};
+
+// Positions of the moving circles at `time`, for a surface of the given size
+vector<SceneCircle> animatedScene(int width, int height, double time) {
+    int centerX = width / 2;
+    int centerY = height / 2;
+    return {
+        // Circle 1: orbiting
+        {centerX + (int)(100 * cos(time)), centerY + (int)(100 * sin(time)), 20, 0xFFFF0000},                // Red
+        // Circle 2: orbiting in opposite direction
+        {centerX + (int)(80 * cos(-time * 1.5)), centerY + (int)(80 * sin(-time * 1.5)), 15, 0xFF00FF00},    // Green
+        // Circle 3: vertical bounce
+        {centerX + 150, centerY + (int)(60 * sin(time * 2)), 12, 0xFF0000FF},                                 // Blue
+        // Circle 4: horizontal bounce
+        {centerX + (int)(120 * sin(time * 1.2)), centerY + 80, 18, 0xFFFFFF00},                               // Yellow
+    };
+}
+
+void drawScene(SDL_Surface* surface, const vector<SceneCircle>& circles) {
+    for (const SceneCircle& c : circles) drawCircle(surface, c.x, c.y, c.radius, c.color);
+}
+
 void drawAnimatedScene(SDL_Surface* surface, double time) {
-    // Draw multiple moving circles
-    int centerX = surface->w / 2;
-    int centerY = surface->h / 2;
-    
-    // Circle 1: orbiting
-    int x1 = centerX + (int)(100 * cos(time));
-    int y1 = centerY + (int)(100 * sin(time));
-    drawCircle(surface, x1, y1, 20, 0xFFFF0000); // Red
-    
-    // Circle 2: orbiting in opposite direction
-    int x2 = centerX + (int)(80 * cos(-time * 1.5));
-    int y2 = centerY + (int)(80 * sin(-time * 1.5));
-    drawCircle(surface, x2, y2, 15, 0xFF00FF00); // Green
-    
-    // Circle 3: vertical bounce
-    int y3 = centerY + (int)(60 * sin(time * 2));
-    drawCircle(surface, centerX + 150, y3, 12, 0xFF0000FF); // Blue
-    
-    // Circle 4: horizontal bounce
-    int x4 = centerX + (int)(120 * sin(time * 1.2));
-    drawCircle(surface, x4, centerY + 80, 18, 0xFFFFFF00); // Yellow
+    drawScene(surface, animatedScene(surface->w, surface->h, time));
 }
 
 uint64_t getCurrentTimeMs() {
@@ -115,6 +446,17 @@ int main(int argc, char** args) {
     SDL_Window* window = NULL;
     SDL_Event event;
 
+    // --copy: book's DoubleBuffer, --surface: window surface, --dirty: window surface with dirty rectangles,
+    // --buffers 2|3: streaming textures (default 3)
+    PresentPath path = PresentPath::StreamingTextures;
+    int bufferCount = 3;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(args[i], "--copy") == 0) path = PresentPath::CopyToWindow;
+        else if (strcmp(args[i], "--surface") == 0) path = PresentPath::WindowSurface;
+        else if (strcmp(args[i], "--dirty") == 0) path = PresentPath::DirtyRects;
+        else if (strcmp(args[i], "--buffers") == 0 && i + 1 < argc) bufferCount = atoi(args[++i]);
+    }
+
     if (SDL_Init(SDL_INIT_VIDEO) < 0) {
         cout << "Error initializing SDL: " << SDL_GetError() << endl;
         return 1;
@@ -127,12 +469,27 @@ int main(int argc, char** args) {
         return 1;
     }
 
-    // Initialize double buffer
-    DoubleBuffer doubleBuffer(window);
+    // Book's copying double buffer, the dirty-rectangle presenter, or the zero-copy presenter
+    DoubleBuffer* doubleBuffer = NULL;
+    DirtyRectPresenter* dirtyPresenter = NULL;
+    PageFlipPresenter* presenter = NULL;
+    string pathName;
+    if (path == PresentPath::CopyToWindow) {
+        doubleBuffer = new DoubleBuffer(window);
+        pathName = "Copy to window";
+    } else if (path == PresentPath::DirtyRects) {
+        dirtyPresenter = new DirtyRectPresenter(window);
+        pathName = "Dirty rectangles";
+    } else {
+        presenter = new PageFlipPresenter(window, path, bufferCount);
+        pathName = presenter->getPath() == PresentPath::WindowSurface ? "Window surface"
+                                                      : "Page flip (" + to_string(presenter->getBufferCount()) + " textures)";
+    }
+    cout << "Presenting with: " << pathName << endl;
     
     uint64_t startTime = getCurrentTimeMs();
     uint64_t lastFrameTime = startTime;
-    int frameCount = 0;
+    FrameStats stats, total;
     
     while (!quit) {
         while (SDL_PollEvent(&event)) {
@@ -143,23 +500,56 @@ int main(int argc, char** args) {
         
         uint64_t currentTime = getCurrentTimeMs();
         double time = (currentTime - startTime) / 1000.0; // Time in seconds
+        auto frameStart = chrono::high_resolution_clock::now();
+        double renderTime = 0;
+        size_t copied = 0, uploaded = 0;
+        double dirtyFraction = 1.0;
+
+        if (doubleBuffer) {
+            // Clear back buffer
+            doubleBuffer->clear(0xFF000000); // Black background
+            
+            // Draw animated scene to back buffer
+            drawAnimatedScene(doubleBuffer->getBackBuffer(), time);
+            renderTime = elapsedMs(frameStart);
+            
+            // Swap buffers (copies the frame into the window surface)
+            doubleBuffer->swap();
+            copied = doubleBuffer->bytesCopiedPerSwap();
+        } else if (dirtyPresenter) {
+            // Clear where the circles were and will be, draw them, update only that
+            int w = 0, h = 0;
+            SDL_GetWindowSizeInPixels(window, &w, &h);
+            vector<SceneCircle> circles = animatedScene(w, h, time);
+            vector<DirtyRect> bounds;
+            for (const SceneCircle& c : circles) bounds.push_back(c.bounds());
+
+            SDL_Surface* frame = dirtyPresenter->beginFrame(bounds, 0xFF000000);
+            if (frame) drawScene(frame, circles);
+            dirtyFraction = dirtyPresenter->dirtyFraction();
+            renderTime = elapsedMs(frameStart);
+            dirtyPresenter->present();
+        } else {
+            // Draw straight into the memory that will be displayed
+            SDL_Surface* frame = presenter->beginFrame();
+            if (frame) {
+                clearSurface(frame, 0xFF000000);
+                drawAnimatedScene(frame, time);
+            }
+            renderTime = elapsedMs(frameStart);
+            presenter->present();
+            uploaded = presenter->bytesUploadedPerFrame();
+        }
+        stats.add(renderTime, elapsedMs(frameStart) - renderTime, copied, uploaded, dirtyFraction);
+        total.add(renderTime, elapsedMs(frameStart) - renderTime, copied, uploaded, dirtyFraction);
         
-        // Clear back buffer
-        doubleBuffer.clear(0xFF000000); // Black background
-        
-        // Draw animated scene to back buffer
-        drawAnimatedScene(doubleBuffer.getBackBuffer(), time);
-        
-        // Swap buffers (display the frame)
-        doubleBuffer.swap();
-        
-        // Frame rate calculation and display
-        frameCount++;
+        // Frame rate and presentation cost, once a second
         if (currentTime - lastFrameTime >= 1000) {
-            char title[256];
-            sprintf(title, "Double Buffering Demo - FPS: %d", frameCount);
+            char title[512];
+            snprintf(title, sizeof(title), "Double Buffering Demo - %s - FPS: %d | %s",
+                     pathName.c_str(), stats.frames, stats.summary().c_str());
             SDL_SetWindowTitle(window, title);
-            frameCount = 0;
+            stats = FrameStats();
             lastFrameTime = currentTime;
         }
         
@@ -167,8 +557,13 @@ int main(int argc, char** args) {
         SDL_Delay(16);
     }
 
+    cout << pathName << ", " << total.frames << " frames: " << total.summary() << endl;
+
+    delete doubleBuffer;
+    delete dirtyPresenter;
+    delete presenter;
     SDL_DestroyWindow(window);
     SDL_Quit();
 
     return 0;
-}
\ No newline at end of file
+}
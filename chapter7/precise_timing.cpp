@@ -2,8 +2,20 @@
 
 #include <unistd.h>
 #include <iostream>
+#include <iomanip>
 #include <chrono>
 #include <thread>
+#include <atomic>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <cstdlib>
+#include <cstdio>
+#include <random>
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#endif
 
 //SDL3 library
 
@@ -36,34 +48,522 @@ public:
     }
 };
 
-class FrameRateController {
-private:
-    double targetFrameTime; // in milliseconds
-    PreciseTimer frameTimer;
-    
+// Fixed-capacity ring of recent frame times. One thread (the render loop)
+// writes, any thread may take a snapshot; neither side ever blocks. Slots are
+// atomics, and a reader drops entries that were overwritten while it copied.
+class FrameTimeRing {
 public:
-    FrameRateController(double targetFPS) {
-        targetFrameTime = 1000.0 / targetFPS;
+    static constexpr size_t CAPACITY = 1024;  // power of two
+
+    void push(double frameMs) {
+        uint64_t n = written.load(std::memory_order_relaxed);
+        slots[n & (CAPACITY - 1)].store(frameMs, std::memory_order_relaxed);
+        written.store(n + 1, std::memory_order_release);
     }
-    
-    void beginFrame() {
-        frameTimer.reset();
+
+    // Most recent frame times, oldest first
+    std::vector<double> snapshot() const {
+        uint64_t end = written.load(std::memory_order_acquire);
+        uint64_t begin = end > CAPACITY ? end - CAPACITY : 0;
+        std::vector<double> out;
+        out.reserve((size_t)(end - begin));
+        for (uint64_t i = begin; i < end; ++i) out.push_back(slots[i & (CAPACITY - 1)].load(std::memory_order_relaxed));
+        // Anything the writer lapped during the copy is newer data in an old slot
+        uint64_t now = written.load(std::memory_order_acquire);
+        size_t stale = now > begin + CAPACITY ? (size_t)std::min<uint64_t>(now - begin - CAPACITY, out.size()) : 0;
+        out.erase(out.begin(), out.begin() + stale);
+        return out;
     }
-    
+
+    uint64_t totalFrames() const { return written.load(std::memory_order_acquire); }
+
+private:
+    std::atomic<double> slots[CAPACITY] = {};
+    std::atomic<uint64_t> written{0};
+};
+
+struct FrameTimeStats {
+    size_t frames = 0;
+    double targetMs = 0;
+    double meanMs = 0, p50Ms = 0, p95Ms = 0, p99Ms = 0, maxMs = 0;
+    double maxJitterMs = 0;  // largest |frame time - target|
+
+    void print(std::ostream& out) const {
+        out << std::fixed << std::setprecision(3) << "frames " << frames << "  target " << targetMs << " ms  mean "
+            << meanMs << "  p50 " << p50Ms << "  p95 " << p95Ms << "  p99 " << p99Ms << "  max " << maxMs
+            << "  max jitter " << maxJitterMs << " ms" << std::endl;
+    }
+};
+
+enum class PacingMode {
+    Fixed,      // hold the requested rate; late frames are simply late
+    Adaptive,   // step down to a lower rate when the work no longer fits, back up when it does
+    SleepOnly   // sleep_for the remaining time and nothing else (the old behaviour, for comparison)
+};
+
+// Paces a render loop to absolute deadlines on the steady clock. The wait
+// sleeps until a calibrated margin before the deadline, then spins the rest,
+// so the OS wake-up overshoot lands inside the spin instead of on the frame.
+// The margin follows the largest overshoot seen recently and decays slowly.
+class FramePacer {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit FramePacer(double targetFPS, PacingMode mode = PacingMode::Fixed) : mode(mode) {
+        // Adaptive rates: the target and its whole divisors, down to 15 FPS
+        rates.push_back(targetFPS);
+        for (int div = 2; mode == PacingMode::Adaptive && targetFPS / div >= 15.0; ++div) rates.push_back(targetFPS / div);
+        lastFrame = frameStart = Clock::now();
+        deadline = lastFrame + period();
+    }
+
+    void beginFrame() { frameStart = Clock::now(); }
+
+    // Waits for the frame's deadline and records the frame-to-frame time
     void endFrame() {
-        double elapsed = frameTimer.getElapsedMs();
-        
-        if (elapsed < targetFrameTime) {
-            double sleepTime = targetFrameTime - elapsed;
-            std::this_thread::sleep_for(std::chrono::duration<double, std::milli>(sleepTime));
+        Clock::time_point workEnd = Clock::now();
+        if (mode == PacingMode::Adaptive) adapt(std::chrono::duration<double, std::milli>(workEnd - frameStart).count());
+
+        if (mode == PacingMode::SleepOnly) {
+            Clock::duration left = deadline - workEnd;
+            if (left > Clock::duration::zero()) std::this_thread::sleep_for(left);
+        } else {
+            waitUntil(deadline);
         }
+
+        Clock::time_point now = Clock::now();
+        lastWakeOvershootMs = workEnd < deadline ? std::chrono::duration<double, std::milli>(now - deadline).count() : -1.0;
+        ring.push(std::chrono::duration<double, std::milli>(now - lastFrame).count());
+        lastFrame = now;
+        // Next deadline is one period after this one, so small overshoots do
+        // not accumulate. After a long stall restart from now rather than
+        // rushing a burst of frames to catch up.
+        deadline += period();
+        if (now > deadline) deadline = now + period();
     }
-    
-    double getLastFrameTime() {
-        return frameTimer.getElapsedMs();
+
+    // The rate index is atomic because stats() reads it from other threads
+    double getTargetFPS() const { return rates[rateIndex.load(std::memory_order_relaxed)]; }
+    double getTargetFrameMs() const { return 1000.0 / getTargetFPS(); }
+    double getSpinMarginMs() const { return spinMarginMs; }
+    // How far past its deadline the last frame woke; negative if it had no time left to wait
+    double getLastWakeOvershootMs() const { return lastWakeOvershootMs; }
+    const FrameTimeRing& frameTimes() const { return ring; }
+
+    // Percentiles over the ring's window; safe to call from another thread
+    FrameTimeStats stats() const {
+        std::vector<double> times = ring.snapshot();
+        FrameTimeStats s;
+        s.targetMs = getTargetFrameMs();
+        s.frames = times.size();
+        if (times.empty()) return s;
+        for (double t : times) {
+            s.meanMs += t;
+            s.maxJitterMs = std::max(s.maxJitterMs, std::fabs(t - s.targetMs));
+        }
+        s.meanMs /= times.size();
+        auto percentile = [&](double p) {
+            size_t k = std::min(times.size() - 1, (size_t)(p * times.size()));
+            std::nth_element(times.begin(), times.begin() + k, times.end());
+            return times[k];
+        };
+        s.p50Ms = percentile(0.50);
+        s.p95Ms = percentile(0.95);
+        s.p99Ms = percentile(0.99);
+        s.maxMs = *std::max_element(times.begin(), times.end());
+        return s;
+    }
+
+private:
+    Clock::duration period() const {
+        return std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / getTargetFPS()));
+    }
+
+    void waitUntil(Clock::time_point target) {
+        const std::chrono::duration<double, std::milli> margin(spinMarginMs);
+        Clock::time_point wakeAt = target - std::chrono::duration_cast<Clock::duration>(margin);
+        if (Clock::now() < wakeAt) {
+            std::this_thread::sleep_until(wakeAt);
+            // Calibrate: how late did the OS wake us?
+            double overshootMs = std::chrono::duration<double, std::milli>(Clock::now() - wakeAt).count();
+            spinMarginMs = std::max(spinMarginMs * 0.99, overshootMs * 1.25);
+            spinMarginMs = std::min(std::max(spinMarginMs, MIN_MARGIN_MS), MAX_MARGIN_MS);
+        }
+        while (Clock::now() < target) {
+#if defined(__x86_64__) || defined(_M_X64)
+            _mm_pause();
+#endif
+        }
+    }
+
+    // Moves one rate step down when the slowest recent frames no longer fit
+    // the budget, and one step up after a long run with plenty of headroom
+    void adapt(double workMs) {
+        workWindow[workCount++ % WORK_WINDOW] = workMs;
+        if (workCount < WORK_WINDOW) return;
+        double slowest = *std::max_element(workWindow, workWindow + WORK_WINDOW);
+        size_t index = rateIndex.load(std::memory_order_relaxed);  // only this thread writes it
+        if (slowest > 0.9 * getTargetFrameMs() && index + 1 < rates.size()) {
+            rateIndex.store(index + 1, std::memory_order_relaxed);
+            workCount = 0;
+        } else if (index > 0 && slowest < 0.6 * 1000.0 / rates[index - 1]) {
+            rateIndex.store(index - 1, std::memory_order_relaxed);
+            workCount = 0;
+        }
+    }
+
+    static constexpr double MIN_MARGIN_MS = 0.2;
+    static constexpr double MAX_MARGIN_MS = 4.0;
+    static constexpr size_t WORK_WINDOW = 120;
+
+    PacingMode mode;
+    std::vector<double> rates;
+    std::atomic<size_t> rateIndex{0};
+    double spinMarginMs = 1.0;
+    double lastWakeOvershootMs = -1.0;
+    Clock::time_point frameStart, lastFrame, deadline;
+    FrameTimeRing ring;
+    double workWindow[WORK_WINDOW] = {};
+    size_t workCount = 0;
+};
+
+// Headless check (--selftest): paces 60 FPS frames with 2-7 ms of busy work
+// under sleep_for only and under the hybrid wait, while another thread polls
+// stats(), and reports the frame-time and wake-overshoot percentiles of each
+bool runPacingSelfTest(int frames) {
+    struct PaceResult {
+        FrameTimeStats stats;
+        size_t polls;
+        std::vector<double> overshootMs;  // wake time minus deadline, frames that waited
+
+        double overshootPercentile(double p) const {
+            std::vector<double> v = overshootMs;
+            if (v.empty()) return 0;
+            size_t k = std::min(v.size() - 1, (size_t)(p * v.size()));
+            std::nth_element(v.begin(), v.begin() + k, v.end());
+            return v[k];
+        }
+        void printOvershoot(std::ostream& out) const {
+            out << std::fixed << std::setprecision(3) << "wake overshoot p50 " << overshootPercentile(0.50)
+                << "  p99 " << overshootPercentile(0.99) << "  max " << overshootPercentile(1.0) << " ms ("
+                << overshootMs.size() << " waits)" << std::endl;
+        }
+    };
+
+    auto pace = [&](PacingMode mode) {
+        FramePacer pacer(60.0, mode);
+        std::atomic<bool> done{false};
+        std::atomic<size_t> polls{0};
+        std::thread reader([&] {
+            while (!done.load()) {
+                if (pacer.stats().targetMs > 0) ++polls;
+                std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            }
+        });
+        std::mt19937 rng(7);
+        std::uniform_real_distribution<double> workMs(2.0, 7.0);
+        std::vector<double> overshoot;
+        for (int i = 0; i < frames; ++i) {
+            pacer.beginFrame();
+            auto until = FramePacer::Clock::now() + std::chrono::duration_cast<FramePacer::Clock::duration>(
+                                                        std::chrono::duration<double, std::milli>(workMs(rng)));
+            while (FramePacer::Clock::now() < until) {}
+            pacer.endFrame();
+            if (pacer.getLastWakeOvershootMs() >= 0) overshoot.push_back(pacer.getLastWakeOvershootMs());
+        }
+        done = true;
+        reader.join();
+        return PaceResult{pacer.stats(), polls.load(), overshoot};
+    };
+
+    auto sleepOnly = pace(PacingMode::SleepOnly);
+    auto hybrid = pace(PacingMode::Fixed);
+    cout << "sleep_for only:    ";
+    sleepOnly.stats.print(cout);
+    cout << "                   ";
+    sleepOnly.printOvershoot(cout);
+    cout << "sleep, then spin:  ";
+    hybrid.stats.print(cout);
+    cout << "                   ";
+    hybrid.printOvershoot(cout);
+    // Tails depend on what else the machine runs, so only medians and the
+    // mean are checked: deadlines must be hit, must not drift, and the hybrid
+    // wait must wake no later than sleep_for does
+    const FrameTimeStats& h = hybrid.stats;
+    double hybridWake = hybrid.overshootPercentile(0.50), sleepWake = sleepOnly.overshootPercentile(0.50);
+    bool ok = std::fabs(h.p50Ms - h.targetMs) < 0.05 && std::fabs(h.meanMs - h.targetMs) < 0.01 * h.targetMs &&
+              hybridWake < 0.05 && hybridWake <= sleepWake && !hybrid.overshootMs.empty() &&
+              hybrid.polls > 0 && sleepOnly.polls > 0;
+    cout << "Hybrid median on target, wakes within 0.05 ms, no drift, stats() polled from another thread: "
+         << (ok ? "✓ PASSED" : "✗ FAILED") << endl;
+    return ok;
+}
+
+// HUD text: glyph atlas and batched text runs from chapter6/glyph_atlas_text.cpp
+// Classic 8x8 bitmap font for printable ASCII (0x20-0x7E)
+// One byte per glyph row, bit 0 = leftmost pixel
+static const uint8_t FONT_8X8[95][8] = {
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // space
+    {0x18, 0x3C, 0x3C, 0x18, 0x18, 0x00, 0x18, 0x00}, // !
+    {0x36, 0x36, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // "
+    {0x36, 0x36, 0x7F, 0x36, 0x7F, 0x36, 0x36, 0x00}, // #
+    {0x0C, 0x3E, 0x03, 0x1E, 0x30, 0x1F, 0x0C, 0x00}, // $
+    {0x00, 0x63, 0x33, 0x18, 0x0C, 0x66, 0x63, 0x00}, // %
+    {0x1C, 0x36, 0x1C, 0x6E, 0x3B, 0x33, 0x6E, 0x00}, // &
+    {0x06, 0x06, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00}, // '
+    {0x18, 0x0C, 0x06, 0x06, 0x06, 0x0C, 0x18, 0x00}, // (
+    {0x06, 0x0C, 0x18, 0x18, 0x18, 0x0C, 0x06, 0x00}, // )
+    {0x00, 0x66, 0x3C, 0xFF, 0x3C, 0x66, 0x00, 0x00}, // *
+    {0x00, 0x0C, 0x0C, 0x3F, 0x0C, 0x0C, 0x00, 0x00}, // +
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x0C, 0x0C, 0x06}, // ,
+    {0x00, 0x00, 0x00, 0x3F, 0x00, 0x00, 0x00, 0x00}, // -
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x0C, 0x0C, 0x00}, // .
+    {0x60, 0x30, 0x18, 0x0C, 0x06, 0x03, 0x01, 0x00}, // /
+    {0x3E, 0x63, 0x73, 0x7B, 0x6F, 0x67, 0x3E, 0x00}, // 0
+    {0x0C, 0x0E, 0x0C, 0x0C, 0x0C, 0x0C, 0x3F, 0x00}, // 1
+    {0x1E, 0x33, 0x30, 0x1C, 0x06, 0x33, 0x3F, 0x00}, // 2
+    {0x1E, 0x33, 0x30, 0x1C, 0x30, 0x33, 0x1E, 0x00}, // 3
+    {0x38, 0x3C, 0x36, 0x33, 0x7F, 0x30, 0x78, 0x00}, // 4
+    {0x3F, 0x03, 0x1F, 0x30, 0x30, 0x33, 0x1E, 0x00}, // 5
+    {0x1C, 0x06, 0x03, 0x1F, 0x33, 0x33, 0x1E, 0x00}, // 6
+    {0x3F, 0x33, 0x30, 0x18, 0x0C, 0x0C, 0x0C, 0x00}, // 7
+    {0x1E, 0x33, 0x33, 0x1E, 0x33, 0x33, 0x1E, 0x00}, // 8
+    {0x1E, 0x33, 0x33, 0x3E, 0x30, 0x18, 0x0E, 0x00}, // 9
+    {0x00, 0x0C, 0x0C, 0x00, 0x00, 0x0C, 0x0C, 0x00}, // :
+    {0x00, 0x0C, 0x0C, 0x00, 0x00, 0x0C, 0x0C, 0x06}, // ;
+    {0x18, 0x0C, 0x06, 0x03, 0x06, 0x0C, 0x18, 0x00}, // <
+    {0x00, 0x00, 0x3F, 0x00, 0x00, 0x3F, 0x00, 0x00}, // =
+    {0x06, 0x0C, 0x18, 0x30, 0x18, 0x0C, 0x06, 0x00}, // >
+    {0x1E, 0x33, 0x30, 0x18, 0x0C, 0x00, 0x0C, 0x00}, // ?
+    {0x3E, 0x63, 0x7B, 0x7B, 0x7B, 0x03, 0x1E, 0x00}, // @
+    {0x0C, 0x1E, 0x33, 0x33, 0x3F, 0x33, 0x33, 0x00}, // A
+    {0x3F, 0x66, 0x66, 0x3E, 0x66, 0x66, 0x3F, 0x00}, // B
+    {0x3C, 0x66, 0x03, 0x03, 0x03, 0x66, 0x3C, 0x00}, // C
+    {0x1F, 0x36, 0x66, 0x66, 0x66, 0x36, 0x1F, 0x00}, // D
+    {0x7F, 0x46, 0x16, 0x1E, 0x16, 0x46, 0x7F, 0x00}, // E
+    {0x7F, 0x46, 0x16, 0x1E, 0x16, 0x06, 0x0F, 0x00}, // F
+    {0x3C, 0x66, 0x03, 0x03, 0x73, 0x66, 0x7C, 0x00}, // G
+    {0x33, 0x33, 0x33, 0x3F, 0x33, 0x33, 0x33, 0x00}, // H
+    {0x1E, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x1E, 0x00}, // I
+    {0x78, 0x30, 0x30, 0x30, 0x33, 0x33, 0x1E, 0x00}, // J
+    {0x67, 0x66, 0x36, 0x1E, 0x36, 0x66, 0x67, 0x00}, // K
+    {0x0F, 0x06, 0x06, 0x06, 0x46, 0x66, 0x7F, 0x00}, // L
+    {0x63, 0x77, 0x7F, 0x7F, 0x6B, 0x63, 0x63, 0x00}, // M
+    {0x63, 0x67, 0x6F, 0x7B, 0x73, 0x63, 0x63, 0x00}, // N
+    {0x1C, 0x36, 0x63, 0x63, 0x63, 0x36, 0x1C, 0x00}, // O
+    {0x3F, 0x66, 0x66, 0x3E, 0x06, 0x06, 0x0F, 0x00}, // P
+    {0x1E, 0x33, 0x33, 0x33, 0x3B, 0x1E, 0x38, 0x00}, // Q
+    {0x3F, 0x66, 0x66, 0x3E, 0x36, 0x66, 0x67, 0x00}, // R
+    {0x1E, 0x33, 0x07, 0x0E, 0x38, 0x33, 0x1E, 0x00}, // S
+    {0x3F, 0x2D, 0x0C, 0x0C, 0x0C, 0x0C, 0x1E, 0x00}, // T
+    {0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x3F, 0x00}, // U
+    {0x33, 0x33, 0x33, 0x33, 0x33, 0x1E, 0x0C, 0x00}, // V
+    {0x63, 0x63, 0x63, 0x6B, 0x7F, 0x77, 0x63, 0x00}, // W
+    {0x63, 0x63, 0x36, 0x1C, 0x1C, 0x36, 0x63, 0x00}, // X
+    {0x33, 0x33, 0x33, 0x1E, 0x0C, 0x0C, 0x1E, 0x00}, // Y
+    {0x7F, 0x63, 0x31, 0x18, 0x4C, 0x66, 0x7F, 0x00}, // Z
+    {0x1E, 0x06, 0x06, 0x06, 0x06, 0x06, 0x1E, 0x00}, // [
+    {0x03, 0x06, 0x0C, 0x18, 0x30, 0x60, 0x40, 0x00}, // backslash
+    {0x1E, 0x18, 0x18, 0x18, 0x18, 0x18, 0x1E, 0x00}, // ]
+    {0x08, 0x1C, 0x36, 0x63, 0x00, 0x00, 0x00, 0x00}, // ^
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF}, // _
+    {0x0C, 0x0C, 0x18, 0x00, 0x00, 0x00, 0x00, 0x00}, // `
+    {0x00, 0x00, 0x1E, 0x30, 0x3E, 0x33, 0x6E, 0x00}, // a
+    {0x07, 0x06, 0x06, 0x3E, 0x66, 0x66, 0x3B, 0x00}, // b
+    {0x00, 0x00, 0x1E, 0x33, 0x03, 0x33, 0x1E, 0x00}, // c
+    {0x38, 0x30, 0x30, 0x3E, 0x33, 0x33, 0x6E, 0x00}, // d
+    {0x00, 0x00, 0x1E, 0x33, 0x3F, 0x03, 0x1E, 0x00}, // e
+    {0x1C, 0x36, 0x06, 0x0F, 0x06, 0x06, 0x0F, 0x00}, // f
+    {0x00, 0x00, 0x6E, 0x33, 0x33, 0x3E, 0x30, 0x1F}, // g
+    {0x07, 0x06, 0x36, 0x6E, 0x66, 0x66, 0x67, 0x00}, // h
+    {0x0C, 0x00, 0x0E, 0x0C, 0x0C, 0x0C, 0x1E, 0x00}, // i
+    {0x30, 0x00, 0x30, 0x30, 0x30, 0x33, 0x33, 0x1E}, // j
+    {0x07, 0x06, 0x66, 0x36, 0x1E, 0x36, 0x67, 0x00}, // k
+    {0x0E, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x1E, 0x00}, // l
+    {0x00, 0x00, 0x33, 0x7F, 0x7F, 0x6B, 0x63, 0x00}, // m
+    {0x00, 0x00, 0x1F, 0x33, 0x33, 0x33, 0x33, 0x00}, // n
+    {0x00, 0x00, 0x1E, 0x33, 0x33, 0x33, 0x1E, 0x00}, // o
+    {0x00, 0x00, 0x3B, 0x66, 0x66, 0x3E, 0x06, 0x0F}, // p
+    {0x00, 0x00, 0x6E, 0x33, 0x33, 0x3E, 0x30, 0x78}, // q
+    {0x00, 0x00, 0x3B, 0x6E, 0x66, 0x06, 0x0F, 0x00}, // r
+    {0x00, 0x00, 0x3E, 0x03, 0x1E, 0x30, 0x1F, 0x00}, // s
+    {0x08, 0x0C, 0x3E, 0x0C, 0x0C, 0x2C, 0x18, 0x00}, // t
+    {0x00, 0x00, 0x33, 0x33, 0x33, 0x33, 0x6E, 0x00}, // u
+    {0x00, 0x00, 0x33, 0x33, 0x33, 0x1E, 0x0C, 0x00}, // v
+    {0x00, 0x00, 0x63, 0x6B, 0x7F, 0x7F, 0x36, 0x00}, // w
+    {0x00, 0x00, 0x63, 0x36, 0x1C, 0x36, 0x63, 0x00}, // x
+    {0x00, 0x00, 0x33, 0x33, 0x33, 0x3E, 0x30, 0x1F}, // y
+    {0x00, 0x00, 0x3F, 0x19, 0x0C, 0x26, 0x3F, 0x00}, // z
+    {0x38, 0x0C, 0x0C, 0x07, 0x0C, 0x0C, 0x38, 0x00}, // {
+    {0x18, 0x18, 0x18, 0x00, 0x18, 0x18, 0x18, 0x00}, // |
+    {0x07, 0x0C, 0x0C, 0x38, 0x0C, 0x0C, 0x07, 0x00}, // }
+    {0x6E, 0x3B, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // ~
+};
+
+// Destination surface (ARGB8888, pitch in pixels): surface->pixels and
+// surface->pitch / 4 taken inside drawFrame's SDL_LockSurface.
+struct Surface32 {
+    uint32_t* pixels;
+    int width;
+    int height;
+    int pitch;
+};
+
+// Pre-rasterized glyph atlas: every glyph is glyphHeight row bitmasks stored
+// contiguously, so drawing a glyph never evaluates a pattern per pixel.
+// 8x16 glyphs are baked from the 8x8 font by doubling every row.
+struct GlyphAtlas {
+    static constexpr int GLYPH_WIDTH = 8;
+    int glyphHeight;
+    int advanceX;
+    int lineHeight;
+    vector<uint8_t> rows; // 128 glyphs * glyphHeight
+
+    GlyphAtlas(int height = 8) : glyphHeight(height == 16 ? 16 : 8) {
+        advanceX = GLYPH_WIDTH;
+        lineHeight = glyphHeight + glyphHeight / 8;
+        rows.assign(128 * glyphHeight, 0);
+
+        int scale = glyphHeight / 8;
+        for (int c = 0x20; c < 0x7F; ++c) {
+            for (int r = 0; r < glyphHeight; ++r) {
+                rows[c * glyphHeight + r] = FONT_8X8[c - 0x20][r / scale];
+            }
+        }
     }
+
+    const uint8_t* glyph(unsigned char c) const {
+        return &rows[(c < 128 ? c : '?') * glyphHeight];
+    }
+};
+
+// One string to draw: position, text and color
+struct TextRun {
+    int x;
+    int y;
+    const char* text;
+    uint32_t color;
 };
 
+// Layout pass: bounding box of a run in pixels (handles '\n')
+struct TextBounds {
+    int x0, y0, x1, y1; // half-open
+};
+
+TextBounds measureTextRun(const TextRun& run, const GlyphAtlas& atlas) {
+    int columns = 0, maxColumns = 0, lines = 1;
+    for (const char* c = run.text; *c; ++c) {
+        if (*c == '\n') {
+            maxColumns = max(maxColumns, columns);
+            columns = 0;
+            ++lines;
+        } else {
+            ++columns;
+        }
+    }
+    maxColumns = max(maxColumns, columns);
+    return {run.x, run.y,
+            run.x + maxColumns * atlas.advanceX,
+            run.y + (lines - 1) * atlas.lineHeight + atlas.glyphHeight};
+}
+
+#ifdef __AVX2__
+// Expands an 8-bit glyph row into 8 lane masks for _mm256_maskstore_epi32
+struct RowMaskTable {
+    alignas(32) int32_t lanes[256][8];
+
+    RowMaskTable() {
+        for (int bits = 0; bits < 256; ++bits) {
+            for (int i = 0; i < 8; ++i) {
+                lanes[bits][i] = (bits >> i) & 1 ? -1 : 0;
+            }
+        }
+    }
+};
+
+static const RowMaskTable rowMasks;
+#endif
+
+// Glyph fully inside the surface: one masked 8-pixel store per glyph row
+static inline void drawGlyphUnclipped(uint32_t* dst, int pitch, const uint8_t* glyphRows,
+                                      int glyphHeight, uint32_t color) {
+#ifdef __AVX2__
+    __m256i colorVec = _mm256_set1_epi32((int)color);
+    for (int r = 0; r < glyphHeight; ++r, dst += pitch) {
+        uint8_t bits = glyphRows[r];
+        if (!bits) continue;
+        __m256i mask = _mm256_load_si256((const __m256i*)rowMasks.lanes[bits]);
+        _mm256_maskstore_epi32((int*)dst, mask, colorVec);
+    }
+#else
+    for (int r = 0; r < glyphHeight; ++r, dst += pitch) {
+        for (unsigned bits = glyphRows[r]; bits; bits &= bits - 1) {
+            dst[__builtin_ctz(bits)] = color;
+        }
+    }
+#endif
+}
+
+// Glyph straddling an edge: restrict rows and columns once, then walk set bits
+static void drawGlyphClipped(const Surface32& surface, int gx, int gy, const uint8_t* glyphRows,
+                             int glyphHeight, uint32_t color) {
+    int rowStart = max(0, -gy);
+    int rowEnd = min(glyphHeight, surface.height - gy);
+    int colStart = max(0, -gx);
+    int colEnd = min(GlyphAtlas::GLYPH_WIDTH, surface.width - gx);
+    if (rowStart >= rowEnd || colStart >= colEnd) return;
+
+    unsigned colMask = ((1u << colEnd) - 1) & ~((1u << colStart) - 1);
+    for (int r = rowStart; r < rowEnd; ++r) {
+        uint32_t* dst = surface.pixels + (size_t)(gy + r) * surface.pitch + gx;
+        for (unsigned bits = glyphRows[r] & colMask; bits; bits &= bits - 1) {
+            dst[__builtin_ctz(bits)] = color;
+        }
+    }
+}
+
+// Batched text renderer: the caller locks the surface once for all runs.
+// Each run is clipped once as a whole; only runs that straddle an edge fall
+// back to per-glyph clipping, and only for the glyphs that actually straddle.
+void drawTextRuns(const Surface32& surface, const TextRun* runs, size_t count,
+                  const GlyphAtlas& atlas) {
+    for (size_t i = 0; i < count; ++i) {
+        const TextRun& run = runs[i];
+        TextBounds bounds = measureTextRun(run, atlas);
+
+        // Entirely off-surface: skip without touching a single glyph
+        if (bounds.x1 <= 0 || bounds.y1 <= 0 ||
+            bounds.x0 >= surface.width || bounds.y0 >= surface.height) {
+            continue;
+        }
+
+        bool inside = bounds.x0 >= 0 && bounds.y0 >= 0 &&
+                      bounds.x1 <= surface.width && bounds.y1 <= surface.height;
+
+        int penX = run.x;
+        int penY = run.y;
+        for (const char* c = run.text; *c; ++c) {
+            if (*c == '\n') {
+                penX = run.x;
+                penY += atlas.lineHeight;
+                continue;
+            }
+
+            const uint8_t* glyphRows = atlas.glyph((unsigned char)*c);
+            if (inside ||
+                (penX >= 0 && penY >= 0 &&
+                 penX + GlyphAtlas::GLYPH_WIDTH <= surface.width &&
+                 penY + atlas.glyphHeight <= surface.height)) {
+                drawGlyphUnclipped(surface.pixels + (size_t)penY * surface.pitch + penX,
+                                   surface.pitch, glyphRows, atlas.glyphHeight, run.color);
+            } else {
+                drawGlyphClipped(surface, penX, penY, glyphRows, atlas.glyphHeight, run.color);
+            }
+            penX += atlas.advanceX;
+        }
+    }
+}
+
 void drawFrame(SDL_Surface* surface, int frameNumber) {
     SDL_LockSurface(surface);
     uint32_t* pixels = (uint32_t*)surface->pixels;
@@ -92,35 +592,13 @@ void drawFrame(SDL_Surface* surface, int frameNumber) {
         }
     }
     
-    // Draw frame counter
+    // Draw frame counter as a text run inside the same lock
+    static const GlyphAtlas hudFont(16);
     char frameText[32];
-    sprintf(frameText, "Frame: %d", frameNumber);
-    
-    // Simple text rendering (draw frame number as bars)
-    int textX = 10;
-    int textY = 10;
-    int digitWidth = 8;
-    int digitHeight = 12;
-    
-    for (int i = 0; frameText[i] && textX + digitWidth < surface->w; ++i) {
-        if (frameText[i] >= '0' && frameText[i] <= '9') {
-            int digit = frameText[i] - '0';
-            // Draw simple digit representation
-            for (int dy = 0; dy < digitHeight; ++dy) {
-                for (int dx = 0; dx < digitWidth; ++dx) {
-                    // Simple pattern for digits (just vertical bars for simplicity)
-                    if ((digit & (1 << (dx % 3))) && dy % 2 == 0) {
-                        int px = textX + dx;
-                        int py = textY + dy;
-                        if (px < surface->w && py < surface->h) {
-                            pixels[py * pitch + px] = 0xFFFFFFFF; // White
-                        }
-                    }
-                }
-            }
-        }
-        textX += digitWidth + 2;
-    }
+    snprintf(frameText, sizeof(frameText), "Frame: %d", frameNumber);
+    const TextRun hud[] = {{10, 10, frameText, 0xFFFFFFFF}};
+    Surface32 target = {pixels, surface->w, surface->h, pitch};
+    drawTextRuns(target, hud, sizeof(hud) / sizeof(hud[0]), hudFont);
     
     SDL_UnlockSurface(surface);
 }
@@ -132,6 +610,18 @@ int main(int argc, char** args) {
     SDL_Window* window = NULL;
     SDL_Event event;
 
+    // --fps N sets the target, --adaptive lets the pacer drop to a lower rate
+    // under load, --sleep-only paces with plain sleep_for for comparison,
+    // --selftest measures both waits without opening a window
+    double targetFPS = 60.0;
+    PacingMode mode = PacingMode::Fixed;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(args[i], "--fps") == 0 && i + 1 < argc) targetFPS = std::max(1.0, atof(args[++i]));
+        else if (strcmp(args[i], "--adaptive") == 0) mode = PacingMode::Adaptive;
+        else if (strcmp(args[i], "--sleep-only") == 0) mode = PacingMode::SleepOnly;
+        else if (strcmp(args[i], "--selftest") == 0) return runPacingSelfTest(600) ? 0 : 1;
+    }
+
     if (SDL_Init(SDL_INIT_VIDEO) < 0) {
         cout << "Error initializing SDL: " << SDL_GetError() << endl;
         return 1;
@@ -155,18 +645,17 @@ int main(int argc, char** args) {
     surface = SDL_ConvertSurface(surface, SDL_PIXELFORMAT_ARGB8888);
 
     // Initialize timing
-    FrameRateController frameController(60.0); // Target 60 FPS
+    FramePacer pacer(targetFPS, mode);
     PreciseTimer totalTimer;
     
     int frameNumber = 0;
-    double totalFrameTime = 0.0;
-    int frameTimeCount = 0;
     
-    cout << "Starting precise timing demo (60 FPS target)" << endl;
+    cout << "Starting precise timing demo (" << targetFPS << " FPS target"
+         << (mode == PacingMode::Adaptive ? ", adaptive" : mode == PacingMode::SleepOnly ? ", sleep only" : "") << ")" << endl;
     cout << "Watch the moving green bar and frame counter" << endl;
     
     while (!quit) {
-        frameController.beginFrame();
+        pacer.beginFrame();
         
         while (SDL_PollEvent(&event)) {
             if (event.type == SDL_EVENT_QUIT) {
@@ -178,24 +667,13 @@ int main(int argc, char** args) {
         drawFrame(surface, frameNumber);
         SDL_UpdateWindowSurface(window);
         
-        frameController.endFrame();
-        
-        // Calculate frame time statistics
-        double frameTime = frameController.getLastFrameTime();
-        totalFrameTime += frameTime;
-        frameTimeCount++;
+        pacer.endFrame();
         
-        // Print statistics every 60 frames
+        // Print frame-time percentiles over the recent window once a second
         if (frameNumber % 60 == 0 && frameNumber > 0) {
-            double avgFrameTime = totalFrameTime / frameTimeCount;
-            double avgFPS = 1000.0 / avgFrameTime;
-            
-            cout << "Frame " << frameNumber 
-                 << " - Avg Frame Time: " << avgFrameTime << "ms"
-                 << " - Avg FPS: " << avgFPS << endl;
-            
-            totalFrameTime = 0.0;
-            frameTimeCount = 0;
+            cout << "Frame " << frameNumber << " - spin margin " << std::fixed << std::setprecision(2)
+                 << pacer.getSpinMarginMs() << " ms - ";
+            pacer.stats().print(cout);
         }
         
         frameNumber++;
@@ -203,9 +681,11 @@ int main(int argc, char** args) {
 
     cout << "Total frames rendered: " << frameNumber << endl;
     cout << "Total time: " << totalTimer.getElapsedMs() / 1000.0 << " seconds" << endl;
+    cout << "Last " << pacer.stats().frames << " frames: ";
+    pacer.stats().print(cout);
 
     SDL_DestroyWindow(window);
     SDL_Quit();
 
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,260 @@
+//Chapter 7: Sprites - Run-Length-Encoded Color-Keyed Sprites
+//Standard C++ libraries
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include <string>
+#include <random>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+
+using namespace std;
+using namespace std::chrono;
+
+// ARGB8888 target, pitch in pixels
+struct SpriteSurface {
+    uint32_t* pixels;
+    int width;
+    int height;
+    int pitch;
+};
+
+// One horizontal run of opaque pixels; the gaps between runs are skipped
+struct SpriteRun {
+    int x;                // first sprite column of the run
+    int length;           // pixels in the run
+    uint32_t dataOffset;  // index of the run's first pixel in the packed pixel array
+};
+
+// Color-keyed sprite compiled once at load time. Every row is stored as its
+// opaque runs only, with their pixels packed back to back, so a blit touches
+// visible pixels and nothing else.
+class RleSprite {
+public:
+    RleSprite(const uint32_t* pixels, int width, int height, int pitch, uint32_t transparentKey)
+        : width(width), height(height), rowRuns(height + 1) {
+        for (int y = 0; y < height; ++y) {
+            rowRuns[y] = (uint32_t)runs.size();
+            const uint32_t* row = pixels + (size_t)y * pitch;
+            for (int x = 0; x < width;) {
+                if (row[x] == transparentKey) { ++x; continue; }
+                int start = x;
+                while (x < width && row[x] != transparentKey) ++x;
+                runs.push_back({start, x - start, (uint32_t)opaque.size()});
+                opaque.insert(opaque.end(), row + start, row + x);
+            }
+        }
+        rowRuns[height] = (uint32_t)runs.size();
+    }
+
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+    size_t opaquePixels() const { return opaque.size(); }
+    size_t runCount() const { return runs.size(); }
+
+    // Draws the sprite with its top-left corner at (x, y). Rows outside the
+    // target are never visited; runs are trimmed to the visible columns, and a
+    // row stops at the first run starting past the right edge. Returns the
+    // number of pixels written.
+    size_t blit(const SpriteSurface& dst, int x, int y) const {
+        // Visible sprite window [sx0, sx1) x [sy0, sy1), clipped in 64-bit
+        int64_t sx0 = max<int64_t>(0, -(int64_t)x), sy0 = max<int64_t>(0, -(int64_t)y);
+        int64_t sx1 = min<int64_t>(width, (int64_t)dst.width - x);
+        int64_t sy1 = min<int64_t>(height, (int64_t)dst.height - y);
+        if (sx0 >= sx1 || sy0 >= sy1) return 0;
+
+        const bool clippedX = sx0 > 0 || sx1 < width;
+        size_t written = 0;
+        for (int64_t sy = sy0; sy < sy1; ++sy) {
+            // Points at sprite column sx0, the first visible one, so the pointer
+            // never lands before the row when x < 0; runs index relative to it
+            uint32_t* out = dst.pixels + (size_t)(y + sy) * dst.pitch + (size_t)(x + sx0);
+            const SpriteRun* run = runs.data() + rowRuns[sy];
+            const SpriteRun* end = runs.data() + rowRuns[sy + 1];
+            if (!clippedX) {
+                for (; run != end; ++run) {
+                    copyRun(out + run->x, opaque.data() + run->dataOffset, run->length);
+                    written += run->length;
+                }
+                continue;
+            }
+            for (; run != end && run->x < sx1; ++run) {
+                int64_t a = max<int64_t>(run->x, sx0), b = min<int64_t>(run->x + run->length, sx1);
+                if (a >= b) continue;  // run lies entirely left of the window
+                copyRun(out + (a - sx0), opaque.data() + run->dataOffset + (a - run->x), (int)(b - a));
+                written += b - a;
+            }
+        }
+        return written;
+    }
+
+private:
+    // Short runs (outlines, antialiasing fringes) are copied inline; longer ones go to memcpy
+    static inline void copyRun(uint32_t* dst, const uint32_t* src, int count) {
+        if (count <= 8) {
+            for (int i = 0; i < count; ++i) dst[i] = src[i];
+        } else {
+            memcpy(dst, src, (size_t)count * sizeof(uint32_t));
+        }
+    }
+
+    int width, height;
+    vector<uint32_t> rowRuns;   // first run of each row; rowRuns[height] ends the last row
+    vector<SpriteRun> runs;
+    vector<uint32_t> opaque;
+};
+
+// ---------------------------------------------------------------------------
+// Book versions: per-pixel key test at draw time
+// ---------------------------------------------------------------------------
+
+// chapter12 blitSprite: bounds-checked getPixel/setPixel for every pixel
+void blitSpriteBook(const SpriteSurface& dst, const SpriteSurface& sprite, int x, int y,
+                    uint32_t transparentColor = 0xFF00FF) {
+    for (int sy = 0; sy < sprite.height; ++sy) {
+        for (int sx = 0; sx < sprite.width; ++sx) {
+            uint32_t color = sprite.pixels[sy * sprite.pitch + sx];
+            if (color != transparentColor) {
+                int px = x + sx, py = y + sy;
+                if (px >= 0 && px < dst.width && py >= 0 && py < dst.height) dst.pixels[py * dst.pitch + px] = color;
+            }
+        }
+    }
+}
+
+// chapter8 drawTileClipped: clipped once, key test per pixel
+void drawTileClippedBook(const SpriteSurface& dst, const SpriteSurface& tile, int destX, int destY,
+                         uint32_t transparentColor = 0xFF00FF) {
+    int srcStartX = max(0, -destX), srcStartY = max(0, -destY);
+    int srcEndX = min(tile.width, dst.width - destX), srcEndY = min(tile.height, dst.height - destY);
+    if (srcStartX >= srcEndX || srcStartY >= srcEndY) return;
+    for (int y = srcStartY; y < srcEndY; ++y) {
+        for (int x = srcStartX; x < srcEndX; ++x) {
+            uint32_t pixel = tile.pixels[y * tile.pitch + x];
+            if (pixel != transparentColor) dst.pixels[(destY + y) * dst.pitch + destX + x] = pixel;
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Verification and benchmark
+// ---------------------------------------------------------------------------
+
+static const uint32_t KEY = 0xFF00FF;
+
+struct Image {
+    vector<uint32_t> pixels;
+    SpriteSurface surface;
+    Image(int w, int h, int pad) : pixels((size_t)(w + pad) * h, 0) { surface = {pixels.data(), w, h, w + pad}; }
+};
+
+// Game-character-like sprite: a few overlapping blobs with a darker outline
+// and some see-through holes, on the transparent key
+Image makeSprite(int w, int h, mt19937& rng, int pad = 0) {
+    Image img(w, h, pad);
+    fill(img.pixels.begin(), img.pixels.end(), KEY);
+    for (int blob = 0; blob < 3; ++blob) {
+        double cx = w * (0.3 + 0.4 * (rng() % 100) / 100.0), cy = h * (0.3 + 0.4 * (rng() % 100) / 100.0);
+        double r = min(w, h) * (0.2 + 0.12 * (rng() % 100) / 100.0);
+        uint32_t color = 0xFF000000u | (rng() & 0xFFFFFF);
+        if (color == KEY) color ^= 1;
+        for (int y = 0; y < h; ++y) {
+            for (int x = 0; x < w; ++x) {
+                double d = hypot(x + 0.5 - cx, y + 0.5 - cy);
+                if (d < r) img.pixels[(size_t)y * img.surface.pitch + x] = d > r - 1.5 ? 0xFF101010u : color;
+            }
+        }
+    }
+    for (int hole = 0; hole < 6; ++hole) {
+        int hx = rng() % w, hy = rng() % h;
+        for (int y = hy; y < min(h, hy + 3); ++y)
+            for (int x = hx; x < min(w, hx + 3); ++x) img.pixels[(size_t)y * img.surface.pitch + x] = KEY;
+    }
+    return img;
+}
+
+bool verifyRleSprites() {
+    mt19937 rng(17);
+    Image ref(97, 71, 5), out(97, 71, 5);
+    for (int trial = 0; trial < 400; ++trial) {
+        int w = 1 + rng() % 60, h = 1 + rng() % 60;
+        Image sprite = makeSprite(w, h, rng, rng() % 4);
+        // Edge cases: fully transparent and fully opaque sprites
+        if (trial == 0) fill(sprite.pixels.begin(), sprite.pixels.end(), KEY);
+        if (trial == 1) fill(sprite.pixels.begin(), sprite.pixels.end(), 0xFF123456u);
+        RleSprite rle(sprite.surface.pixels, w, h, sprite.surface.pitch, KEY);
+
+        for (int pos = 0; pos < 20; ++pos) {
+            int x = (int)(rng() % 190) - 70, y = (int)(rng() % 160) - 65;
+            if (pos == 0) { x = INT32_MIN + 5; y = 3; }  // far off-screen must not overflow
+            for (size_t i = 0; i < ref.pixels.size(); ++i) ref.pixels[i] = out.pixels[i] = (uint32_t)i * 2654435761u;
+            if (pos != 0) blitSpriteBook(ref.surface, sprite.surface, x, y, KEY);
+            rle.blit(out.surface, x, y);
+            if (ref.pixels != out.pixels) {
+                cout << "  mismatch: " << w << "x" << h << " sprite at (" << x << "," << y << ")" << endl;
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+template <typename Fn>
+double timeMs(int iterations, Fn fn) {
+    auto start = high_resolution_clock::now();
+    for (int i = 0; i < iterations; ++i) fn();
+    return duration<double, milli>(high_resolution_clock::now() - start).count() / iterations;
+}
+
+int main(int argc, char** args) {
+    cout << "=== Chapter 7: Run-Length-Encoded Color-Keyed Sprites ===" << endl;
+    cout << "RLE blit vs per-pixel key test (random sizes, clipped on all sides): "
+         << (verifyRleSprites() ? "✓ PASSED" : "✗ FAILED") << endl;
+
+    Image screen(1920, 1080, 0);
+    mt19937 rng(3);
+
+    cout << "\n=== 2000 sprites per frame at 1920x1080 (ms per frame) ===" << endl;
+    cout << left << setw(10) << "Sprite" << right << setw(13) << "transparent" << setw(8) << "runs"
+         << setw(12) << "blitSprite" << setw(14) << "tileClipped" << setw(8) << "RLE" << setw(10) << "speedup"
+         << setw(14) << "ns/visible px" << endl;
+    for (int size : {16, 32, 64, 128}) {
+        vector<Image> sprites;
+        vector<RleSprite> compiled;
+        size_t total = 0, visible = 0, runs = 0;
+        for (int i = 0; i < 8; ++i) {
+            sprites.push_back(makeSprite(size, size, rng));
+            compiled.emplace_back(sprites.back().surface.pixels, size, size, size, KEY);
+            total += (size_t)size * size;
+            visible += compiled.back().opaquePixels();
+            runs += compiled.back().runCount();
+        }
+
+        struct Placement { int sprite, x, y; };
+        vector<Placement> frame(2000);
+        for (auto& p : frame) p = {(int)(rng() % 8), (int)(rng() % (1920 + size)) - size, (int)(rng() % (1080 + size)) - size};
+
+        double book = timeMs(3, [&] {
+            for (auto& p : frame) blitSpriteBook(screen.surface, sprites[p.sprite].surface, p.x, p.y, KEY);
+        });
+        double tile = timeMs(3, [&] {
+            for (auto& p : frame) drawTileClippedBook(screen.surface, sprites[p.sprite].surface, p.x, p.y, KEY);
+        });
+        size_t written = 0;
+        double rle = timeMs(3, [&] {
+            written = 0;
+            for (auto& p : frame) written += compiled[p.sprite].blit(screen.surface, p.x, p.y);
+        });
+
+        string name = to_string(size) + "x" + to_string(size);
+        cout << left << setw(10) << name << right << fixed << setprecision(0) << setw(12)
+             << 100.0 * (total - visible) / total << "%" << setw(8) << runs / 8 << setprecision(3)
+             << setw(12) << book << setw(14) << tile << setw(8) << rle << setw(9) << setprecision(1)
+             << tile / rle << "x" << setw(14) << setprecision(2) << rle * 1e6 / written << endl;
+    }
+    cout << "(speedup is RLE vs the clipped per-pixel loop; runs is per sprite)" << endl;
+    return 0;
+}
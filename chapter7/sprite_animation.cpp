@@ -3,6 +3,10 @@
 #include <unistd.h>
 #include <iostream>
 #include <chrono>
+#include <cmath>
+#include <cstring>
+#include <cstdlib>
+#include <algorithm>
 
 //SDL3 library
 
@@ -29,9 +33,13 @@ struct Vec2 {
     float x, y;
 };
 
+// Simulated position is kept in floats at the fixed step; the integer
+// sprite.x/y is only written when a frame is drawn, from interpolated state
 struct MovingSprite {
     Sprite sprite;
     Vec2 velocity;
+    Vec2 position;
+    Vec2 previous;  // position before the latest step, for interpolation
 };
 
 uint64_t getCurrentTimeMs() {
@@ -40,14 +48,68 @@ uint64_t getCurrentTimeMs() {
     return std::chrono::duration_cast<std::chrono::milliseconds>(duration).count();
 }
 
+// Turns variable frame times into a whole number of fixed simulation steps.
+// Leftover time carries over in the accumulator, and alpha() says how far the
+// frame sits between the last two steps. A frame spike can only trigger
+// maxStepsPerFrame steps; time beyond that is dropped (the game slows down
+// briefly instead of spiralling).
+class FixedTimestep {
+public:
+    FixedTimestep(double stepHz, int maxStepsPerFrame = 8)
+        : step(1.0 / stepHz), maxSteps(maxStepsPerFrame) {}
+
+    // Adds one frame's real time and returns how many steps to simulate
+    int advance(double frameSeconds) {
+        accumulator += std::max(0.0, frameSeconds);
+        int steps = (int)(accumulator / step);
+        if (steps > maxSteps) {
+            droppedSeconds += (steps - maxSteps) * step;
+            steps = maxSteps;
+        }
+        accumulator = std::fmod(accumulator, step);
+        return steps;
+    }
+
+    double getStep() const { return step; }
+    double alpha() const { return accumulator / step; }
+    double getDroppedSeconds() const { return droppedSeconds; }
+
+private:
+    double step;
+    int maxSteps;
+    double accumulator = 0.0;
+    double droppedSeconds = 0.0;
+};
+
 void updateSpritePosition(Sprite& sprite, int dx, int dy) {
     sprite.x += dx;
     sprite.y += dy;
 }
 
+// One fixed simulation step
 void update(MovingSprite& ms, float deltaTime) {
-    ms.sprite.x += static_cast<int>(ms.velocity.x * deltaTime);
-    ms.sprite.y += static_cast<int>(ms.velocity.y * deltaTime);
+    ms.previous = ms.position;
+    ms.position.x += ms.velocity.x * deltaTime;
+    ms.position.y += ms.velocity.y * deltaTime;
+}
+
+// Reflects the sprite off the edges of a width x height area
+void bounce(MovingSprite& ms, int width, int height) {
+    float maxX = (float)(width - ms.sprite.frameWidth), maxY = (float)(height - ms.sprite.frameHeight);
+    if (ms.position.x < 0 || ms.position.x > maxX) {
+        ms.position.x = ms.position.x < 0 ? -ms.position.x : 2 * maxX - ms.position.x;
+        ms.velocity.x = -ms.velocity.x;
+    }
+    if (ms.position.y < 0 || ms.position.y > maxY) {
+        ms.position.y = ms.position.y < 0 ? -ms.position.y : 2 * maxY - ms.position.y;
+        ms.velocity.y = -ms.velocity.y;
+    }
+}
+
+// Places the sprite between the last two simulated positions for drawing
+void interpolate(MovingSprite& ms, float alpha) {
+    ms.sprite.x = (int)std::lround(ms.previous.x + (ms.position.x - ms.previous.x) * alpha);
+    ms.sprite.y = (int)std::lround(ms.previous.y + (ms.position.y - ms.previous.y) * alpha);
 }
 
 void updateAnimation(Sprite& sprite, uint64_t currentTimeMs) {
@@ -122,6 +184,12 @@ int main(int argc, char** args) {
     // Convert to ARGB8888 format
     surface = SDL_ConvertSurface(surface, SDL_PIXELFORMAT_ARGB8888);
 
+    // --hz N sets the simulation rate (default 240 Hz); drawing stays at ~60 FPS
+    double simulationHz = 240.0;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(args[i], "--hz") == 0 && i + 1 < argc) simulationHz = std::max(1.0, atof(args[++i]));
+    }
+
     // Initialize sprite
     MovingSprite movingSprite;
     movingSprite.sprite.x = 100;
@@ -134,8 +202,11 @@ int main(int argc, char** args) {
     movingSprite.sprite.lastFrameTime = getCurrentTimeMs();
     movingSprite.velocity.x = 60.0f;  // pixels per second
     movingSprite.velocity.y = 40.0f;
+    movingSprite.position = {100.0f, 100.0f};
+    movingSprite.previous = movingSprite.position;
     
-    uint64_t lastTime = getCurrentTimeMs();
+    FixedTimestep timestep(simulationHz);
+    auto lastTime = std::chrono::steady_clock::now();
     
     while (!quit) {
         while (SDL_PollEvent(&event)) {
@@ -144,23 +215,20 @@ int main(int argc, char** args) {
             }
         }
         
-        uint64_t currentTime = getCurrentTimeMs();
-        float deltaTime = (currentTime - lastTime) / 1000.0f;
+        auto currentTime = std::chrono::steady_clock::now();
+        double frameSeconds = std::chrono::duration<double>(currentTime - lastTime).count();
         lastTime = currentTime;
         
         // Update sprite animation
-        updateAnimation(movingSprite.sprite, currentTime);
+        updateAnimation(movingSprite.sprite, getCurrentTimeMs());
         
-        // Update sprite position with bouncing
-        update(movingSprite, deltaTime);
-        
-        // Bounce off edges
-        if (movingSprite.sprite.x <= 0 || movingSprite.sprite.x + movingSprite.sprite.frameWidth >= surface->w) {
-            movingSprite.velocity.x = -movingSprite.velocity.x;
-        }
-        if (movingSprite.sprite.y <= 0 || movingSprite.sprite.y + movingSprite.sprite.frameHeight >= surface->h) {
-            movingSprite.velocity.y = -movingSprite.velocity.y;
+        // Simulate in fixed steps, bouncing off the edges
+        int steps = timestep.advance(frameSeconds);
+        for (int i = 0; i < steps; ++i) {
+            update(movingSprite, (float)timestep.getStep());
+            bounce(movingSprite, surface->w, surface->h);
         }
+        interpolate(movingSprite, (float)timestep.alpha());
         
         // Clear and draw
         clear_surface(surface);
@@ -0,0 +1,461 @@
+//Chapter 7: Sprites - Sprite Atlas Packer and Atlas-Based Animation
+//Standard C++ libraries
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include <random>
+#include <memory>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+
+using namespace std;
+using namespace std::chrono;
+
+// ARGB8888 target, pitch in pixels
+struct AtlasSurface {
+    uint32_t* pixels;
+    int width;
+    int height;
+    int pitch;
+};
+
+// Skyline bottom-left rectangle packer. The skyline is the top edge of
+// everything placed so far, kept as horizontal segments; each rect goes
+// where its top ends lowest, ties broken by the narrower fit. Widths are
+// rounded up to `align` pixels, so every rect starts on an aligned column.
+class SkylinePacker {
+public:
+    SkylinePacker(int width, int height, int align) : width(width), height(height), align(align) {
+        skyline.push_back({0, 0, width});
+    }
+
+    bool insert(int w, int h, int& outX, int& outY) {
+        w = (w + align - 1) / align * align;
+        size_t best = SIZE_MAX;
+        int bestTop = INT32_MAX, bestWidth = INT32_MAX, bestY = 0;
+        for (size_t i = 0; i < skyline.size(); ++i) {
+            int y;
+            if (!fits(i, w, h, y)) continue;
+            if (y + h < bestTop || (y + h == bestTop && skyline[i].w < bestWidth)) {
+                best = i;
+                bestTop = y + h;
+                bestWidth = skyline[i].w;
+                bestY = y;
+            }
+        }
+        if (best == SIZE_MAX) return false;
+        outX = skyline[best].x;
+        outY = bestY;
+        place(best, w, bestY + h);
+        return true;
+    }
+
+    // Height actually used so far
+    int usedHeight() const {
+        int top = 0;
+        for (const Segment& s : skyline) top = max(top, s.y);
+        return top;
+    }
+
+private:
+    struct Segment {
+        int x, y, w;
+    };
+
+    // Does a w x h rect fit with its left edge on segment i? y is where it would sit.
+    bool fits(size_t i, int w, int h, int& y) const {
+        if (skyline[i].x + w > width) return false;
+        y = 0;
+        for (int left = w; left > 0; ++i) {
+            y = max(y, skyline[i].y);
+            if (y + h > height) return false;
+            left -= skyline[i].w;
+        }
+        return true;
+    }
+
+    void place(size_t i, int w, int top) {
+        Segment placed = {skyline[i].x, top, w};
+        skyline.insert(skyline.begin() + i, placed);
+        // Trim or drop the segments now covered by the new one
+        for (size_t j = i + 1; j < skyline.size();) {
+            int covered = placed.x + placed.w - skyline[j].x;
+            if (covered <= 0) break;
+            if (covered < skyline[j].w) {
+                skyline[j].x += covered;
+                skyline[j].w -= covered;
+                break;
+            }
+            skyline.erase(skyline.begin() + j);
+        }
+        // Merge neighbours at the same height
+        for (size_t j = 0; j + 1 < skyline.size();) {
+            if (skyline[j].y == skyline[j + 1].y) {
+                skyline[j].w += skyline[j + 1].w;
+                skyline.erase(skyline.begin() + j + 1);
+            } else {
+                ++j;
+            }
+        }
+    }
+
+    int width, height, align;
+    vector<Segment> skyline;
+};
+
+// Where one animation frame lives: its trimmed rect on an atlas page, and the
+// offset of that rect inside the original (untrimmed) frame
+struct AtlasFrame {
+    int page;
+    int x, y, w, h;
+    int offsetX, offsetY;
+    int sourceWidth, sourceHeight;
+};
+
+// Frames to play in order; the clip only stores atlas frame ids
+struct AnimationClip {
+    vector<uint32_t> frames;
+    int frameDelayMs;
+
+    uint32_t frameAt(uint64_t timeMs) const { return frames[(timeMs / frameDelayMs) % frames.size()]; }
+};
+
+// Color-keyed frames packed at load time into a few large pages. Each frame
+// is trimmed to the bounding box of its opaque pixels before packing. Pages
+// start on a 64-byte boundary with a pitch that is a multiple of 64 bytes,
+// and every rect starts on a 16-byte column, so rows never straddle more
+// cache lines than they must. Frames from many sprites share pages instead
+// of each sprite owning a separate strip.
+class SpriteAtlas {
+public:
+    static constexpr int COLUMN_ALIGN = 4;  // pixels: 16 bytes
+    static constexpr int PADDING = 1;      // key-colored gap between rects
+
+    explicit SpriteAtlas(int pageSize = 1024, uint32_t transparentKey = 0xFF00FF)
+        : pageSize((pageSize + 15) & ~15), key(transparentKey) {}
+
+    // Queues a frame; pixels are copied. Returns the frame id used by clips and blit().
+    uint32_t addFrame(const uint32_t* pixels, int width, int height, int pitch) {
+        Pending p;
+        p.width = width;
+        p.height = height;
+        p.pixels.resize((size_t)width * height);
+        for (int y = 0; y < height; ++y) memcpy(&p.pixels[(size_t)y * width], pixels + (size_t)y * pitch, (size_t)width * 4);
+        pending.push_back(move(p));
+        return (uint32_t)(pending.size() - 1);
+    }
+
+    // Trims, packs and copies every queued frame. Tallest frames go first,
+    // which keeps the skyline flat; frames larger than a page are rejected.
+    bool build() {
+        frames.assign(pending.size(), AtlasFrame{});
+        vector<uint32_t> order(pending.size());
+        for (uint32_t i = 0; i < order.size(); ++i) {
+            trim(pending[i], frames[i]);
+            order[i] = i;
+        }
+        stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return frames[a].h > frames[b].h; });
+
+        vector<SkylinePacker> packers;
+        for (uint32_t id : order) {
+            AtlasFrame& f = frames[id];
+            if (f.w == 0) continue;  // fully transparent: nothing to store
+            if (f.w + PADDING > pageSize || f.h + PADDING > pageSize) return false;
+            int x = 0, y = 0;
+            size_t page = 0;
+            while (page < packers.size() && !packers[page].insert(f.w + PADDING, f.h + PADDING, x, y)) ++page;
+            if (page == packers.size()) {
+                packers.emplace_back(pageSize, pageSize, COLUMN_ALIGN);
+                packers.back().insert(f.w + PADDING, f.h + PADDING, x, y);
+            }
+            f.page = (int)page;
+            f.x = x;
+            f.y = y;
+        }
+
+        // Allocate only the rows each page uses, then copy the trimmed pixels in
+        pages.clear();
+        for (const SkylinePacker& packer : packers) {
+            Page page;
+            page.height = packer.usedHeight();
+            size_t count = (size_t)pageSize * page.height;
+            page.pixels.reset(static_cast<uint32_t*>(aligned_alloc(64, (count * 4 + 63) & ~(size_t)63)));
+            fill(page.pixels.get(), page.pixels.get() + count, key);
+            pages.push_back(move(page));
+        }
+        for (uint32_t id = 0; id < frames.size(); ++id) {
+            const AtlasFrame& f = frames[id];
+            const Pending& p = pending[id];
+            for (int y = 0; y < f.h; ++y) {
+                memcpy(pages[f.page].pixels.get() + (size_t)(f.y + y) * pageSize + f.x,
+                       &p.pixels[(size_t)(f.offsetY + y) * p.width + f.offsetX], (size_t)f.w * 4);
+            }
+        }
+        pending.clear();
+        return true;
+    }
+
+    // Frames in the built atlas (queued frames are not counted until build())
+    size_t frameCount() const { return frames.size(); }
+    const AtlasFrame& getFrame(uint32_t id) const { return frames[id]; }
+    size_t pageCount() const { return pages.size(); }
+    int getPitch() const { return pageSize; }
+    const uint32_t* pagePixels(int page) const { return pages[page].pixels.get(); }
+    size_t bytes() const {
+        size_t total = 0;
+        for (const Page& p : pages) total += (size_t)pageSize * p.height * 4;
+        return total;
+    }
+
+    // Draws frame id with its untrimmed top-left corner at (x, y), skipping
+    // key-colored pixels. Only the trimmed rect is visited.
+    void blit(const AtlasSurface& dst, uint32_t id, int x, int y) const {
+        const AtlasFrame& f = frames[id];
+        int64_t dx = (int64_t)x + f.offsetX, dy = (int64_t)y + f.offsetY;
+        int64_t sx0 = max<int64_t>(0, -dx), sy0 = max<int64_t>(0, -dy);
+        int64_t sx1 = min<int64_t>(f.w, dst.width - dx), sy1 = min<int64_t>(f.h, dst.height - dy);
+        if (sx0 >= sx1 || sy0 >= sy1) return;
+        const uint32_t* src = pages[f.page].pixels.get() + (size_t)(f.y + sy0) * pageSize + f.x;
+        uint32_t* out = dst.pixels + (size_t)(dy + sy0) * dst.pitch + dx;
+        for (int64_t sy = sy0; sy < sy1; ++sy, src += pageSize, out += dst.pitch) {
+            for (int64_t sx = sx0; sx < sx1; ++sx) {
+                uint32_t pixel = src[sx];
+                if (pixel != key) out[sx] = pixel;
+            }
+        }
+    }
+
+private:
+    struct Pending {
+        int width, height;
+        vector<uint32_t> pixels;
+    };
+
+    struct AlignedFree {
+        void operator()(uint32_t* p) const { free(p); }
+    };
+
+    struct Page {
+        unique_ptr<uint32_t, AlignedFree> pixels;
+        int height = 0;
+    };
+
+    // Shrinks the frame to the bounding box of its non-key pixels
+    void trim(const Pending& p, AtlasFrame& f) const {
+        int x0 = p.width, y0 = p.height, x1 = -1, y1 = -1;
+        for (int y = 0; y < p.height; ++y) {
+            const uint32_t* row = &p.pixels[(size_t)y * p.width];
+            for (int x = 0; x < p.width; ++x) {
+                if (row[x] == key) continue;
+                x0 = min(x0, x);
+                x1 = max(x1, x);
+                y0 = min(y0, y);
+                y1 = max(y1, y);
+            }
+        }
+        f = {0, 0, 0, 0, 0, 0, 0, p.width, p.height};
+        if (x1 < 0) return;
+        f.w = x1 - x0 + 1;
+        f.h = y1 - y0 + 1;
+        f.offsetX = x0;
+        f.offsetY = y0;
+    }
+
+    int pageSize;
+    uint32_t key;
+    vector<Pending> pending;
+    vector<AtlasFrame> frames;
+    vector<Page> pages;
+};
+
+// ---------------------------------------------------------------------------
+// Book version: every sprite owns one horizontal strip of equal-size frames
+// (chapter7 Sprite, srcX = frameIndex * frameWidth), drawn with a key test
+// ---------------------------------------------------------------------------
+
+struct StripSprite {
+    uint8_t* imageData;  // separate allocation per sprite
+    int width;           // whole strip
+    int height;
+    int frameWidth;
+    int frameHeight;
+    int totalFrames;
+};
+
+void drawStripFrameBook(const AtlasSurface& dst, const StripSprite& sprite, int frameIndex, int x, int y,
+                        uint32_t transparentColor = 0xFF00FF) {
+    const uint32_t* strip = (const uint32_t*)sprite.imageData;
+    int srcX = frameIndex * sprite.frameWidth;
+    int srcStartX = max(0, -x), srcStartY = max(0, -y);
+    int srcEndX = min(sprite.frameWidth, dst.width - x), srcEndY = min(sprite.frameHeight, dst.height - y);
+    for (int sy = srcStartY; sy < srcEndY; ++sy) {
+        for (int sx = srcStartX; sx < srcEndX; ++sx) {
+            uint32_t pixel = strip[sy * sprite.width + srcX + sx];
+            if (pixel != transparentColor) dst.pixels[(y + sy) * dst.pitch + x + sx] = pixel;
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Verification and benchmark
+// ---------------------------------------------------------------------------
+
+static const uint32_t KEY = 0xFF00FF;
+
+struct Image {
+    vector<uint32_t> pixels;
+    AtlasSurface surface;
+    Image(int w, int h, int pad) : pixels((size_t)(w + pad) * h, 0) { surface = {pixels.data(), w, h, w + pad}; }
+};
+
+// A sprite sheet strip: frames drawn as a blob that bobs and grows across
+// the animation, leaving wide transparent borders like exported art does
+StripSprite makeStrip(int frameWidth, int frameHeight, int frames, mt19937& rng) {
+    StripSprite s = {nullptr, frameWidth * frames, frameHeight, frameWidth, frameHeight, frames};
+    uint32_t* strip = new uint32_t[(size_t)s.width * s.height];
+    fill(strip, strip + (size_t)s.width * s.height, KEY);
+    uint32_t color = 0xFF000000u | (rng() & 0xFFFFFF);
+    if (color == KEY) color ^= 1;
+    double cx = frameWidth * (0.4 + 0.2 * (rng() % 100) / 100.0), cy = frameHeight * (0.4 + 0.2 * (rng() % 100) / 100.0);
+    double base = min(frameWidth, frameHeight) * (0.15 + 0.15 * (rng() % 100) / 100.0);
+    for (int f = 0; f < frames; ++f) {
+        double r = base * (1.0 + 0.25 * sin(f * 0.8)), oy = base * 0.3 * cos(f * 0.8);
+        for (int y = 0; y < frameHeight; ++y) {
+            for (int x = 0; x < frameWidth; ++x) {
+                double d = hypot(x + 0.5 - cx, y + 0.5 - cy - oy);
+                if (d < r) strip[(size_t)y * s.width + f * frameWidth + x] = d > r - 1.5 ? 0xFF101010u : color + (uint32_t)f * 8;
+            }
+        }
+    }
+    s.imageData = (uint8_t*)strip;
+    return s;
+}
+
+bool verifyPacker() {
+    mt19937 rng(25);
+    for (int trial = 0; trial < 50; ++trial) {
+        int size = 64 + (int)(rng() % 200);
+        SkylinePacker packer(size, size, 4);
+        vector<uint8_t> used((size_t)size * size, 0);
+        for (int i = 0; i < 400; ++i) {
+            int w = 1 + rng() % 40, h = 1 + rng() % 40, x, y;
+            if (!packer.insert(w, h, x, y)) continue;
+            if (x % 4 != 0 || x < 0 || y < 0 || x + w > size || y + h > size) return false;
+            for (int py = y; py < y + h; ++py)
+                for (int px = x; px < x + w; ++px) if (used[(size_t)py * size + px]++) return false;
+        }
+    }
+    return true;
+}
+
+bool verifyAtlasBlit() {
+    mt19937 rng(7);
+    SpriteAtlas atlas(256, KEY);
+    vector<StripSprite> strips;
+    vector<uint32_t> firstFrame;
+    for (int i = 0; i < 60; ++i) {
+        StripSprite s = makeStrip(4 + rng() % 70, 4 + rng() % 70, 1 + rng() % 6, rng);
+        if (i == 0) fill((uint32_t*)s.imageData, (uint32_t*)s.imageData + (size_t)s.width * s.height, KEY);
+        if (i == 1) fill((uint32_t*)s.imageData, (uint32_t*)s.imageData + (size_t)s.width * s.height, 0xFF123456u);
+        strips.push_back(s);
+        for (int f = 0; f < s.totalFrames; ++f) {
+            uint32_t id = atlas.addFrame((const uint32_t*)s.imageData + f * s.frameWidth, s.frameWidth, s.frameHeight, s.width);
+            if (f == 0) firstFrame.push_back(id);
+        }
+    }
+    if (!atlas.build()) return false;
+
+    bool ok = true;
+    Image ref(150, 110, 3), out(150, 110, 3);
+    for (size_t i = 0; i < strips.size() && ok; ++i) {
+        for (int f = 0; f < strips[i].totalFrames && ok; ++f) {
+            for (int pos = 0; pos < 10 && ok; ++pos) {
+                int x = (int)(rng() % 220) - 70, y = (int)(rng() % 180) - 70;
+                for (size_t p = 0; p < ref.pixels.size(); ++p) ref.pixels[p] = out.pixels[p] = (uint32_t)p * 2654435761u;
+                drawStripFrameBook(ref.surface, strips[i], f, x, y, KEY);
+                atlas.blit(out.surface, firstFrame[i] + f, x, y);
+                if (ref.pixels != out.pixels) {
+                    cout << "  mismatch: sprite " << i << " frame " << f << " at (" << x << "," << y << ")" << endl;
+                    ok = false;
+                }
+            }
+        }
+    }
+    for (StripSprite& s : strips) delete[] (uint32_t*)s.imageData;
+    return ok;
+}
+
+template <typename Fn>
+double timeMs(int iterations, Fn fn) {
+    auto start = high_resolution_clock::now();
+    for (int i = 0; i < iterations; ++i) fn();
+    return duration<double, milli>(high_resolution_clock::now() - start).count() / iterations;
+}
+
+int main(int argc, char** args) {
+    cout << "=== Chapter 7: Sprite Atlas Packer and Atlas-Based Animation ===" << endl;
+    cout << "Skyline packer: aligned, in bounds, no overlaps: " << (verifyPacker() ? "✓ PASSED" : "✗ FAILED") << endl;
+    cout << "Trimmed atlas blit vs per-sprite strip blit (clipped on all sides): "
+         << (verifyAtlasBlit() ? "✓ PASSED" : "✗ FAILED") << endl;
+
+    // 400 sprites, 8 frames each, 24-96 px frames; each strip its own allocation
+    const int SPRITES = 400, FRAMES = 8, DRAWS = 20000;
+    mt19937 rng(11);
+    vector<StripSprite> strips;
+    vector<vector<uint8_t>> spacers;  // other load-time allocations between strips, as in a real loader
+    size_t stripBytes = 0;
+    for (int i = 0; i < SPRITES; ++i) {
+        int size = 24 + (int)(rng() % 73);
+        strips.push_back(makeStrip(size, size, FRAMES, rng));
+        spacers.emplace_back(4096 + rng() % 65536);
+        stripBytes += (size_t)strips.back().width * strips.back().height * 4;
+    }
+
+    auto start = high_resolution_clock::now();
+    SpriteAtlas atlas(2048, KEY);
+    vector<AnimationClip> clips(SPRITES);
+    for (int i = 0; i < SPRITES; ++i) {
+        clips[i].frameDelayMs = 100;
+        for (int f = 0; f < FRAMES; ++f) {
+            clips[i].frames.push_back(
+                atlas.addFrame((const uint32_t*)strips[i].imageData + f * strips[i].frameWidth, strips[i].frameWidth,
+                               strips[i].frameHeight, strips[i].width));
+        }
+    }
+    atlas.build();
+    double buildMs = duration<double, milli>(high_resolution_clock::now() - start).count();
+    size_t trimmedArea = 0;
+    for (uint32_t id = 0; id < atlas.frameCount(); ++id) trimmedArea += (size_t)atlas.getFrame(id).w * atlas.getFrame(id).h;
+
+    struct Draw { int sprite, x, y; uint64_t timeMs; };
+    vector<Draw> draws(DRAWS);
+    for (Draw& d : draws) d = {(int)(rng() % SPRITES), (int)(rng() % 1990) - 70, (int)(rng() % 1150) - 70, rng() % 10000};
+
+    Image screen(1920, 1080, 0);
+    double book = timeMs(5, [&] {
+        for (const Draw& d : draws) {
+            const StripSprite& s = strips[d.sprite];
+            drawStripFrameBook(screen.surface, s, (int)((d.timeMs / 100) % s.totalFrames), d.x, d.y, KEY);
+        }
+    });
+    double packed = timeMs(5, [&] {
+        for (const Draw& d : draws) atlas.blit(screen.surface, clips[d.sprite].frameAt(d.timeMs), d.x, d.y);
+    });
+
+    cout << "\n=== " << SPRITES << " sprites x " << FRAMES << " frames (24-96 px), " << DRAWS << " draws per frame ===" << endl;
+    cout << fixed << setprecision(2);
+    cout << "Per-sprite strips:  " << setw(7) << stripBytes / 1048576.0 << " MB in " << SPRITES << " allocations" << endl;
+    cout << "Atlas:              " << setw(7) << atlas.bytes() / 1048576.0 << " MB in " << atlas.pageCount()
+         << " page(s) of 2048 px, " << setprecision(1) << 100.0 * trimmedArea * 4 / atlas.bytes() << "% filled, built in "
+         << buildMs << " ms" << endl;
+    cout << setprecision(3);
+    cout << "Strip blit:         " << setw(7) << book << " ms per frame" << endl;
+    cout << "Atlas blit:         " << setw(7) << packed << " ms per frame  (" << setprecision(1) << book / packed << "x)" << endl;
+
+    for (StripSprite& s : strips) delete[] (uint32_t*)s.imageData;
+    return 0;
+}
@@ -0,0 +1,407 @@
+//Chapter 7: Sprites - Structure-of-Arrays Sprite Batch
+//Standard C++ libraries
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include <random>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+
+//SIMD intrinsics
+#include <immintrin.h>  // AVX2 update and culling (scalar fallback)
+
+using namespace std;
+using namespace std::chrono;
+
+// ARGB8888 target or atlas, pitch in pixels
+struct BatchSurface {
+    uint32_t* pixels;
+    int width;
+    int height;
+    int pitch;
+};
+
+// One animation frame in the atlas
+struct AtlasRect {
+    int x, y, w, h;
+};
+
+// Compact draw command: where to put which atlas rect, in target coordinates
+struct SpriteDraw {
+    int32_t x, y;
+    uint32_t rect;
+};
+
+// Visible window into the world, in world pixels
+struct ViewRect {
+    int x, y, w, h;
+};
+
+// Many moving sprites stored one array per field, so update and culling
+// stream through exactly the fields they use, 8 sprites per AVX2 step.
+// Every sprite keeps the size of its first atlas rect for bounce and cull;
+// all frames of one animation are expected to share that size.
+class SpriteBatch {
+public:
+    SpriteBatch(const vector<AtlasRect>& atlasRects, float worldWidth, float worldHeight)
+        : rects(atlasRects), worldWidth(worldWidth), worldHeight(worldHeight) {}
+
+    size_t add(float x, float y, float vx, float vy, uint32_t firstRect, int frameCount, int startFrame = 0) {
+        const AtlasRect& r = rects[firstRect];
+        posX.push_back(x);
+        posY.push_back(y);
+        velX.push_back(vx);
+        velY.push_back(vy);
+        maxX.push_back(worldWidth - r.w);
+        maxY.push_back(worldHeight - r.h);
+        width.push_back(r.w);
+        height.push_back(r.h);
+        first.push_back((int32_t)firstRect);
+        frames.push_back(frameCount);
+        frame.push_back(startFrame % frameCount);
+        return posX.size() - 1;
+    }
+
+    size_t size() const { return posX.size(); }
+    float getX(size_t i) const { return posX[i]; }
+    float getY(size_t i) const { return posY[i]; }
+    int getFrame(size_t i) const { return frame[i]; }
+
+    // Moves every sprite by velocity * dt and reflects it off the world edges
+    void update(float dt, bool simd = true) {
+        size_t i = 0, n = size();
+#ifdef __AVX2__
+        if (simd) {
+            const __m256 vdt = _mm256_set1_ps(dt), zero = _mm256_setzero_ps();
+            const __m256 sign = _mm256_set1_ps(-0.0f);
+            for (; i + 8 <= n; i += 8) {
+                integrate8(posX.data() + i, velX.data() + i, maxX.data() + i, vdt, zero, sign);
+                integrate8(posY.data() + i, velY.data() + i, maxY.data() + i, vdt, zero, sign);
+            }
+        }
+#endif
+        for (; i < n; ++i) {
+            integrate1(posX[i], velX[i], maxX[i], dt);
+            integrate1(posY[i], velY[i], maxY[i], dt);
+        }
+    }
+
+    // Steps every sprite to its next animation frame, wrapping at its frame count
+    void animate(bool simd = true) {
+        size_t i = 0, n = size();
+#ifdef __AVX2__
+        if (simd) {
+            const __m256i one = _mm256_set1_epi32(1);
+            for (; i + 8 <= n; i += 8) {
+                __m256i f = _mm256_add_epi32(_mm256_loadu_si256((const __m256i*)(frame.data() + i)), one);
+                __m256i wrap = _mm256_cmpgt_epi32(_mm256_loadu_si256((const __m256i*)(frames.data() + i)), f);
+                _mm256_storeu_si256((__m256i*)(frame.data() + i), _mm256_and_si256(f, wrap));
+            }
+        }
+#endif
+        for (; i < n; ++i) frame[i] = frame[i] + 1 < frames[i] ? frame[i] + 1 : 0;
+    }
+
+    // Appends a draw command, in view coordinates, for every sprite that
+    // overlaps the view. Sprites are drawn at their truncated position.
+    void cull(const ViewRect& view, vector<SpriteDraw>& out, bool simd = true) const {
+        size_t i = 0, n = size();
+#ifdef __AVX2__
+        if (simd) {
+            const __m256i left = _mm256_set1_epi32(view.x), top = _mm256_set1_epi32(view.y);
+            const __m256i right = _mm256_set1_epi32(view.x + view.w), bottom = _mm256_set1_epi32(view.y + view.h);
+            alignas(32) int32_t ix[8], iy[8];
+            for (; i + 8 <= n; i += 8) {
+                __m256i x = _mm256_cvttps_epi32(_mm256_loadu_ps(posX.data() + i));
+                __m256i y = _mm256_cvttps_epi32(_mm256_loadu_ps(posY.data() + i));
+                __m256i w = _mm256_loadu_si256((const __m256i*)(width.data() + i));
+                __m256i h = _mm256_loadu_si256((const __m256i*)(height.data() + i));
+                // x < right && x + w > left && y < bottom && y + h > top
+                __m256i visible = _mm256_and_si256(
+                    _mm256_and_si256(_mm256_cmpgt_epi32(right, x), _mm256_cmpgt_epi32(_mm256_add_epi32(x, w), left)),
+                    _mm256_and_si256(_mm256_cmpgt_epi32(bottom, y), _mm256_cmpgt_epi32(_mm256_add_epi32(y, h), top)));
+                unsigned mask = (unsigned)_mm256_movemask_ps(_mm256_castsi256_ps(visible));
+                if (!mask) continue;
+                _mm256_store_si256((__m256i*)ix, _mm256_sub_epi32(x, left));
+                _mm256_store_si256((__m256i*)iy, _mm256_sub_epi32(y, top));
+                for (; mask; mask &= mask - 1) {
+                    int lane = __builtin_ctz(mask);
+                    out.push_back({ix[lane], iy[lane], (uint32_t)(first[i + lane] + frame[i + lane])});
+                }
+            }
+        }
+#endif
+        for (; i < n; ++i) {
+            int x = (int)posX[i], y = (int)posY[i];
+            if (x < view.x + view.w && x + width[i] > view.x && y < view.y + view.h && y + height[i] > view.y) {
+                out.push_back({x - view.x, y - view.y, (uint32_t)(first[i] + frame[i])});
+            }
+        }
+    }
+
+private:
+    static inline void integrate1(float& p, float& v, float limit, float dt) {
+        p = p + v * dt;
+        bool low = p < 0.0f, high = p > limit;
+        if (low) p = -p;
+        else if (high) p = (limit + limit) - p;
+        if (low || high) v = -v;
+    }
+
+#ifdef __AVX2__
+    // Same operations as integrate1 (no FMA), so both paths agree bit for bit
+    static inline void integrate8(float* p, float* v, const float* limit, __m256 dt, __m256 zero, __m256 sign) {
+        __m256 vel = _mm256_loadu_ps(v), lim = _mm256_loadu_ps(limit);
+        __m256 pos = _mm256_add_ps(_mm256_loadu_ps(p), _mm256_mul_ps(vel, dt));
+        __m256 low = _mm256_cmp_ps(pos, zero, _CMP_LT_OQ), high = _mm256_cmp_ps(pos, lim, _CMP_GT_OQ);
+        __m256 reflected = _mm256_blendv_ps(_mm256_sub_ps(_mm256_add_ps(lim, lim), pos), _mm256_xor_ps(pos, sign), low);
+        __m256 hit = _mm256_or_ps(low, high);
+        _mm256_storeu_ps(p, _mm256_blendv_ps(pos, reflected, hit));
+        _mm256_storeu_ps(v, _mm256_xor_ps(vel, _mm256_and_ps(hit, sign)));
+    }
+#endif
+
+    vector<AtlasRect> rects;
+    float worldWidth, worldHeight;
+    vector<float> posX, posY, velX, velY, maxX, maxY;
+    vector<int32_t> width, height, first, frames, frame;
+};
+
+// Copies each command's atlas rect to the target, clipped to its edges
+void drawBatch(const BatchSurface& dst, const BatchSurface& atlas, const vector<AtlasRect>& rects,
+               const vector<SpriteDraw>& draws) {
+    for (const SpriteDraw& d : draws) {
+        const AtlasRect& r = rects[d.rect];
+        int sx0 = max(0, -d.x), sy0 = max(0, -d.y);
+        int sx1 = min(r.w, dst.width - d.x), sy1 = min(r.h, dst.height - d.y);
+        if (sx0 >= sx1 || sy0 >= sy1) continue;
+        const uint32_t* src = atlas.pixels + (size_t)(r.y + sy0) * atlas.pitch + r.x + sx0;
+        uint32_t* out = dst.pixels + (size_t)(d.y + sy0) * dst.pitch + d.x + sx0;
+        size_t bytes = (size_t)(sx1 - sx0) * sizeof(uint32_t);
+        for (int y = sy0; y < sy1; ++y, src += atlas.pitch, out += dst.pitch) memcpy(out, src, bytes);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Book version: one struct per sprite (chapter7 Sprite + MovingSprite layout),
+// updated, tested and drawn one at a time with per-pixel bounds checks
+// ---------------------------------------------------------------------------
+
+struct BookSprite {
+    uint8_t* imageData;
+    int width;
+    int height;
+    float x;
+    float y;
+    int frameIndex;
+    int totalFrames;
+    int frameWidth;
+    int frameHeight;
+    int frameDelayMs;
+    uint64_t lastFrameTime;
+    float velocityX, velocityY;
+    uint32_t firstRect;
+};
+
+void updateBook(BookSprite& s, float dt, float worldWidth, float worldHeight, bool nextFrame) {
+    s.x = s.x + s.velocityX * dt;
+    s.y = s.y + s.velocityY * dt;
+    float maxX = worldWidth - s.frameWidth, maxY = worldHeight - s.frameHeight;
+    if (s.x < 0 || s.x > maxX) {
+        s.x = s.x < 0 ? -s.x : (maxX + maxX) - s.x;
+        s.velocityX = -s.velocityX;
+    }
+    if (s.y < 0 || s.y > maxY) {
+        s.y = s.y < 0 ? -s.y : (maxY + maxY) - s.y;
+        s.velocityY = -s.velocityY;
+    }
+    if (nextFrame) s.frameIndex = (s.frameIndex + 1) % s.totalFrames;
+}
+
+void drawSpriteBook(const BatchSurface& dst, const BatchSurface& atlas, const vector<AtlasRect>& rects,
+                    const BookSprite& s, const ViewRect& view) {
+    const AtlasRect& r = rects[s.firstRect + s.frameIndex];
+    int baseX = (int)s.x - view.x, baseY = (int)s.y - view.y;
+    for (int y = 0; y < s.frameHeight; ++y) {
+        for (int x = 0; x < s.frameWidth; ++x) {
+            int dx = baseX + x, dy = baseY + y;
+            if (dx >= 0 && dx < dst.width && dy >= 0 && dy < dst.height) {
+                dst.pixels[dy * dst.pitch + dx] = atlas.pixels[(r.y + y) * atlas.pitch + r.x + x];
+            }
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Verification and benchmark
+// ---------------------------------------------------------------------------
+
+struct Image {
+    vector<uint32_t> pixels;
+    BatchSurface surface;
+    Image(int w, int h, int pad) : pixels((size_t)(w + pad) * h, 0) { surface = {pixels.data(), w, h, w + pad}; }
+};
+
+// Atlas of animations: sizes 8, 12, 16 and 24 px, 8 frames each, in rows
+struct Atlas {
+    Image image;
+    vector<AtlasRect> rects;
+    vector<uint32_t> firstRects;
+    Atlas() : image(8 * 24, 4 * 24, 0) {
+        const int sizes[4] = {8, 12, 16, 24};
+        for (int a = 0; a < 4; ++a) {
+            firstRects.push_back((uint32_t)rects.size());
+            for (int f = 0; f < 8; ++f) {
+                AtlasRect r = {f * 24, a * 24, sizes[a], sizes[a]};
+                rects.push_back(r);
+                for (int y = 0; y < r.h; ++y)
+                    for (int x = 0; x < r.w; ++x)
+                        image.pixels[(size_t)(r.y + y) * image.surface.pitch + r.x + x] =
+                            0xFF000000u | (uint32_t)(a * 60 + f * 20) << 16 | (uint32_t)(x * 10) << 8 | (uint32_t)(y * 10);
+            }
+        }
+    }
+};
+
+struct Scene {
+    SpriteBatch batch;
+    vector<BookSprite> book;
+    Scene(const Atlas& atlas, size_t count, float worldW, float worldH, uint32_t seed) : batch(atlas.rects, worldW, worldH) {
+        mt19937 rng(seed);
+        uniform_real_distribution<float> speed(-240.0f, 240.0f);
+        for (size_t i = 0; i < count; ++i) {
+            int kind = (int)(rng() % 4);
+            uint32_t firstRect = atlas.firstRects[kind];
+            const AtlasRect& r = atlas.rects[firstRect];
+            float x = (float)(rng() % (int)(worldW - r.w)), y = (float)(rng() % (int)(worldH - r.h));
+            float vx = speed(rng), vy = speed(rng);
+            int startFrame = (int)(rng() % 8);
+            batch.add(x, y, vx, vy, firstRect, 8, startFrame);
+            book.push_back({nullptr, 8 * r.w, r.h, x, y, startFrame, 8, r.w, r.h, 100, 0, vx, vy, firstRect});
+        }
+    }
+};
+
+bool verifySpriteBatch() {
+    Atlas atlas;
+    const float worldW = 700, worldH = 500;
+    for (size_t count : {0, 1, 7, 8, 9, 333, 1000}) {
+        Scene scalar(atlas, count, worldW, worldH, 24 + (uint32_t)count), simd(atlas, count, worldW, worldH, 24 + (uint32_t)count);
+        Image expect(320, 200, 3), actual(320, 200, 3);
+        vector<SpriteDraw> drawsScalar, drawsSimd;
+        for (int step = 0; step < 300; ++step) {
+            bool nextFrame = step % 6 == 0;
+            scalar.batch.update(1.0f / 240, false);
+            simd.batch.update(1.0f / 240, true);
+            if (nextFrame) { scalar.batch.animate(false); simd.batch.animate(true); }
+            for (BookSprite& s : scalar.book) updateBook(s, 1.0f / 240, worldW, worldH, nextFrame);
+
+            for (size_t i = 0; i < count; ++i) {
+                const BookSprite& b = scalar.book[i];
+                if (scalar.batch.getX(i) != b.x || scalar.batch.getY(i) != b.y || simd.batch.getX(i) != b.x ||
+                    simd.batch.getY(i) != b.y || simd.batch.getFrame(i) != b.frameIndex ||
+                    scalar.batch.getFrame(i) != b.frameIndex) {
+                    cout << "  state mismatch: sprite " << i << " of " << count << " at step " << step << endl;
+                    return false;
+                }
+            }
+            if (step % 25 != 0) continue;
+
+            // View partly outside the world on purpose
+            ViewRect view = {step - 40, step / 2 - 30, 320, 200};
+            drawsScalar.clear();
+            drawsSimd.clear();
+            scalar.batch.cull(view, drawsScalar, false);
+            simd.batch.cull(view, drawsSimd, true);
+            fill(expect.pixels.begin(), expect.pixels.end(), 0xFF000000u);
+            fill(actual.pixels.begin(), actual.pixels.end(), 0xFF000000u);
+            for (const BookSprite& s : scalar.book) drawSpriteBook(expect.surface, atlas.image.surface, atlas.rects, s, view);
+            drawBatch(actual.surface, atlas.image.surface, atlas.rects, drawsSimd);
+            bool sameList = drawsScalar.size() == drawsSimd.size();
+            for (size_t i = 0; sameList && i < drawsScalar.size(); ++i) {
+                sameList = drawsScalar[i].x == drawsSimd[i].x && drawsScalar[i].y == drawsSimd[i].y &&
+                           drawsScalar[i].rect == drawsSimd[i].rect;
+            }
+            if (!sameList || expect.pixels != actual.pixels) {
+                cout << "  " << (sameList ? "image" : "draw list") << " mismatch: " << count << " sprites, step " << step << endl;
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+template <typename Fn>
+double timeMs(int iterations, Fn fn) {
+    auto start = high_resolution_clock::now();
+    for (int i = 0; i < iterations; ++i) fn();
+    return duration<double, milli>(high_resolution_clock::now() - start).count() / iterations;
+}
+
+int main(int argc, char** args) {
+    cout << "=== Chapter 7: Structure-of-Arrays Sprite Batch ===" << endl;
+    cout << "SoA scalar/AVX2 update, cull and draw vs per-sprite book loop: "
+         << (verifySpriteBatch() ? "✓ PASSED" : "✗ FAILED") << endl;
+#ifndef __AVX2__
+    cout << "(built without AVX2: SoA paths run scalar; compile with -march=native)" << endl;
+#endif
+
+    const int W = 1920, H = 1080, COUNT = 100000, FRAMES = 30;
+    const float worldW = 3840, worldH = 2160;
+    const float dt = 1.0f / 60;
+    Atlas atlas;
+    Scene scene(atlas, COUNT, worldW, worldH, 7);
+    Image screen(W, H, 0);
+    vector<SpriteDraw> draws;
+    draws.reserve(COUNT);
+    int frameNo = 0;
+    auto viewAt = [&](int f) { return ViewRect{(f * 7) % (int)(worldW - W), (f * 3) % (int)(worldH - H), W, H}; };
+
+    // Book: update, then test and draw one sprite at a time
+    double bookUpdate = timeMs(FRAMES, [&] {
+        for (BookSprite& s : scene.book) updateBook(s, dt, worldW, worldH, frameNo % 6 == 0);
+        ++frameNo;
+    });
+    double bookDraw = timeMs(FRAMES, [&] {
+        ViewRect view = viewAt(frameNo++);
+        for (const BookSprite& s : scene.book) drawSpriteBook(screen.surface, atlas.image.surface, atlas.rects, s, view);
+    });
+
+    struct Timing { double update, cull, draw; size_t visible; };
+    auto runBatch = [&](bool simd) {
+        Timing t{};
+        t.update = timeMs(FRAMES, [&] {
+            scene.batch.update(dt, simd);
+            if (frameNo++ % 6 == 0) scene.batch.animate(simd);
+        });
+        t.cull = timeMs(FRAMES, [&] {
+            draws.clear();
+            scene.batch.cull(viewAt(frameNo++), draws, simd);
+        });
+        t.visible = draws.size();
+        t.draw = timeMs(FRAMES, [&] { drawBatch(screen.surface, atlas.image.surface, atlas.rects, draws); });
+        return t;
+    };
+    Timing scalar = runBatch(false);
+    Timing simd = runBatch(true);
+
+    cout << "\n=== " << COUNT << " sprites (8-24 px) in a 3840x2160 world, 1920x1080 view (ms per frame) ===" << endl;
+    cout << left << setw(22) << "Path" << right << setw(10) << "update" << setw(10) << "cull" << setw(10) << "draw"
+         << setw(10) << "total" << setw(10) << "speedup" << endl;
+    double bookTotal = bookUpdate + bookDraw;
+    auto row = [&](const char* name, double u, double c, double d) {
+        cout << left << setw(22) << name << right << fixed << setprecision(3) << setw(10) << u << setw(10) << c
+             << setw(10) << d << setw(10) << u + c + d << setw(9) << setprecision(1) << bookTotal / (u + c + d) << "x" << endl;
+    };
+    cout << left << setw(22) << "Book (AoS, per-pixel)" << right << fixed << setprecision(3) << setw(10) << bookUpdate
+         << setw(10) << "-" << setw(10) << bookDraw << setw(10) << bookTotal << setw(10) << "1.0x" << endl;
+    row("SoA scalar", scalar.update, scalar.cull, scalar.draw);
+    row("SoA AVX2", simd.update, simd.cull, simd.draw);
+    double total = simd.update + simd.cull + simd.draw;
+    cout << "Visible: " << simd.visible << " of " << COUNT << " sprites; SoA AVX2 frame uses " << setprecision(1)
+         << 100.0 * total / (1000.0 / 60) << "% of a 60 FPS budget" << endl;
+    return 0;
+}